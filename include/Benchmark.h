@@ -0,0 +1,22 @@
+#pragma once
+#include <functional>
+#include <string>
+
+namespace Benchmark {
+    /**
+     * Receives one line of the benchmark results
+     */
+    using Reporter = std::function<void(const std::string&)>;
+
+    /**
+     * Measures the throughput of the LEDHat drawing paths
+     *
+     * The benchmarks draw on a separate led matrix with the geometry of the hat which is not connected
+     * to any output, so the shown content is not touched. Every result is reported as one JSON line:
+     *
+     *     {"benchmark":"drawText","case":"wrap around","iterations":2000,"ns_per_op":8150}
+     *
+     * @param report Receives the result lines
+     */
+    void run(const Reporter& report);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "characters.h"
+
+/**
+ * A font to draw texts with: either the font compiled into the firmware or a binary font file
+ *
+ * Binary fonts are generated by tools/generateCharacters.py (see there for the format). The glyphs are
+ * rendered straight from the file buffer, only the position of the tables is computed when loading.
+ */
+class Font {
+public:
+    /**
+     * Gets the font compiled into the firmware (characters_definition.h)
+     */
+    static const Font& builtin();
+
+    /**
+     * Creates a font from the content of a binary font file
+     *
+     * @param[in] data Content of the font file, kept by the font
+     * @param[out] font The font
+     * @returns true if the file is a valid font
+     */
+    static bool load(std::vector<uint8_t> data, Font& font);
+
+    Font() : _id( nextId() ) {}
+
+    /**
+     * Gets the Character entry of the codepoint, see getCharacter()
+     *
+     * @param[in] codepoint Unicode codepoint of the character
+     * @param[out] character Character entry, the columns point into the font
+     * @returns false for control characters
+     */
+    bool getCharacter(uint32_t codepoint, Character& character) const;
+
+    /**
+     * Gets the width of the Character entry without touching its columns, see getCharacterWidth()
+     *
+     * @returns The width in columns or -1 for control characters
+     */
+    int getCharacterWidth(uint32_t codepoint) const;
+
+    /**
+     * Gets the unique id of the font (e.g. to identify cached texts of a font)
+     */
+    uint32_t id() const { return _id; }
+
+    /**
+     * Gets the coverage bits per pixel of the glyphs: 1 for plain fonts, 2 or 4 for anti-aliased fonts
+     */
+    unsigned int bits() const { return _bits; }
+
+    /**
+     * Gets the rows of the glyphs
+     */
+    unsigned int height() const { return _height; }
+
+private:
+    /**
+     * Gets the index of the glyph of the codepoint in the binary font
+     *
+     * @returns The index or -1 for control characters
+     */
+    int glyphIndex(uint32_t codepoint) const;
+
+    /**
+     * Reads a little endian value from the font data (not aligned)
+     */
+    uint32_t read(size_t offset, unsigned int bytes) const;
+
+    static uint32_t nextId();
+
+    uint32_t _id;
+
+    /**
+     * true for the compiled font, which uses the lookup functions of characters.h
+     */
+    bool _builtin = false;
+
+    /**
+     * Content of the font file
+     */
+    std::vector<uint8_t> _data;
+
+    unsigned int _height = 0;
+    unsigned int _bits = 1; ///< coverage bits per pixel
+    unsigned int _glyphCount = 0;
+    unsigned int _directCount = 0;
+    uint32_t _firstCodepoint = 0;
+
+    /**
+     * Offsets of the tables in the data
+     */
+    size_t _metrics = 0;
+    size_t _codepoints = 0;
+    size_t _columns = 0;
+};
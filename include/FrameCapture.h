@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdio>
+#include <vector>
+
+#include <FastLED.h>
+
+#include "MatrixGeometry.h"
+
+/**
+ * Records the transmitted frames to a file and/or shows them as ANSI terminal preview
+ *
+ * Every frame is written as record (little endian):
+ *
+ *     uint32 timestamp       millis() after the frame was transmitted
+ *     uint32 render duration micros spent composing & rendering the frame
+ *     uint8  output          index of the led matrix, see LEDHat::outputs()
+ *     uint8  rows
+ *     uint16 cols
+ *     rows * cols * RGB      pixels after the output stage, column by column (col * rows + row)
+ *
+ * The file starts with the magic "LHCF" followed by the version byte 1.
+ */
+class FrameCapture {
+public:
+    /**
+     * @param[in] path File to record the frames to (nullptr = no recording)
+     * @param[in] preview Show every frame as true color blocks on stdout
+     */
+    explicit FrameCapture(const char* path, bool preview = false);
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * Checks if the recording file could be opened (always true without recording)
+     */
+    bool isOpen() const { return !_recording || _file != nullptr; }
+
+    /**
+     * Records one transmitted frame
+     *
+     * @param[in] output Index of the led matrix
+     * @param[in] geometry Geometry of the led matrix
+     * @param[in] leds The frame in led order
+     * @param[in] timestamp millis() after the frame was transmitted
+     * @param[in] renderMicros Duration of composing & rendering the frame
+     */
+    void write(unsigned int output, const MatrixGeometry& geometry, const CRGB* leds, unsigned long timestamp, unsigned long renderMicros);
+
+private:
+    /**
+     * Writes the value as little endian with given number of bytes
+     */
+    void writeValue(uint32_t value, unsigned int bytes);
+
+    /**
+     * Prints the frame as colored blocks, each led matrix below the previous one
+     */
+    void preview(unsigned int output, const MatrixGeometry& geometry, const CRGB* leds);
+
+    bool _recording;
+    FILE* _file = nullptr;
+    bool _preview;
+
+    /**
+     * Terminal line where the preview of every output starts
+     */
+    std::vector<unsigned int> _previewLines;
+
+    /**
+     * First terminal line after the previews
+     */
+    unsigned int _previewEnd = 1;
+};
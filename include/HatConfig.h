@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * Build configuration of the hat. Every value can be overridden by a build flag, so a hat variant
+ * only needs its own environment in platformio.ini:
+ *
+ *     build_flags = -std=gnu++17 -D LEDHAT_COLS=48 -D LEDHAT_PIN=14 -D LEDHAT_MOUNTING=FlipY
+ *
+ * LEDHAT_WIRING, LEDHAT_MAJOR & LEDHAT_MOUNTING take the names of the Wiring, Major & Mounting values.
+ */
+
+/**
+ * Rows & columns of the led matrix of the hat
+ */
+#ifndef LEDHAT_ROWS
+#define LEDHAT_ROWS 8
+#endif
+
+#ifndef LEDHAT_COLS
+#define LEDHAT_COLS 64
+#endif
+
+/**
+ * How the led strip runs through the matrix, see MatrixLayout
+ */
+#ifndef LEDHAT_WIRING
+#define LEDHAT_WIRING Serpentine
+#endif
+
+#ifndef LEDHAT_MAJOR
+#define LEDHAT_MAJOR Column
+#endif
+
+#ifndef LEDHAT_MOUNTING
+#define LEDHAT_MOUNTING Normal
+#endif
+
+/**
+ * The pin of the ESP32 where the hat is connected
+ */
+#ifndef LEDHAT_PIN
+#define LEDHAT_PIN 13
+#endif
@@ -1,29 +1,335 @@
 #pragma once
 #include <FastLED.h>
+#include <array>
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
 
+#include "Font.h"
+#include "FrameCapture.h"
+#include "HatConfig.h"
+#include "MatrixGeometry.h"
+#include "Sprite.h"
+#include "TextStrip.h"
 #include "characters.h"
 
+/**
+ * Layout of the led matrix of the hat, by default 8 rows & 64 columns with the strip zig-zagging along the columns.
+ * Hats of other sizes or wiring change it by build flags, see HatConfig.h
+ */
+using HatLayout = MatrixLayout<LEDHAT_ROWS, LEDHAT_COLS, Wiring::LEDHAT_WIRING, Major::LEDHAT_MAJOR, Mounting::LEDHAT_MOUNTING>;
+
 class LEDHat
 {
 public:
     /**
-     * Singleton instance function
+     * How a layer is combined with the layers below it. Black pixels of a layer are transparent
+     * for Replace & Alpha. Multiply uses the layer as a mask where white keeps the pixels below.
+     */
+    enum class BlendMode
+    {
+        Replace,  ///< pixels replace the ones below
+        Add,      ///< pixels scaled by the opacity are added to the ones below
+        Alpha,    ///< pixels are mixed with the ones below by the opacity
+        Multiply, ///< pixels below are multiplied with the pixels, mixed by the opacity
+    };
+
+    /**
+     * Horizontal alignment of a text inside its box
+     */
+    enum class TextAlign
+    {
+        Left,
+        Center,
+        Right,
+    };
+
+    /**
+     * Handling of a text wider than its box
+     */
+    enum class TextOverflow
+    {
+        Clip,     ///< the columns outside the box are not drawn
+        Ellipsis, ///< the text is shortened until it fits together with "..."
+    };
+
+    /**
+     * Colors of a text drawn with one call of drawText(const char *, const TextColors &, ...)
+     *
+     *     hat.drawText("Hello", LEDHat::TextColors::rainbow(hue++));
+     */
+    struct TextColors
+    {
+        /**
+         * How the color changes along the text
+         */
+        enum class Mode
+        {
+            Characters, ///< the characters take the colors one after another (repeated if the text is longer)
+            Gradient,   ///< linear gradient between two colors
+            Palette,    ///< gradient through a range of palette entries, see setPaletteColor()
+            Rainbow,    ///< the full hue circle starting at the hue offset
+        };
+
+        /**
+         * Columns a gradient is spread across
+         */
+        enum class Span
+        {
+            Text,   ///< the columns of the text, the colors move with the text
+            Canvas, ///< the columns of the canvas, the colors stay in place while the text moves
+        };
+
+        /**
+         * Colors the characters one after another
+         *
+         * @param[in] colors Color of every character
+         */
+        static TextColors characters(std::vector<CRGB> colors);
+
+        /**
+         * Colors the text with a linear gradient
+         *
+         * @param[in] from Color of the first column
+         * @param[in] to Color of the last column
+         * @param[in] span Columns the gradient is spread across
+         */
+        static TextColors gradient(CRGB from, CRGB to, Span span = Span::Text);
+
+        /**
+         * Colors the text with a range of palette entries
+         *
+         * @param[in] first Palette entry of the first column
+         * @param[in] last Palette entry of the last column
+         * @param[in] span Columns the gradient is spread across
+         */
+        static TextColors palette(uint8_t first, uint8_t last, Span span = Span::Text);
+
+        /**
+         * Colors the text with a rainbow. Changing the hue offset every frame lets the colors run
+         *
+         * @param[in] hueOffset Hue of the first column
+         * @param[in] span Columns the rainbow is spread across
+         */
+        static TextColors rainbow(uint8_t hueOffset = 0, Span span = Span::Text);
+
+        Mode mode = Mode::Characters;
+        Span span = Span::Text;
+        std::vector<CRGB> colors; ///< colors of the characters, from & to of a gradient
+        uint8_t first = 0;        ///< first palette entry
+        uint8_t last = 255;       ///< last palette entry
+        uint8_t hueOffset = 0;
+    };
+
+    /**
+     * Gets the hat itself (HatLayout connected to PIN)
      *
-     * @returns The singleton instance of the LEDHat
+     * @returns The instance of the hat
      */
     static LEDHat &Instance();
 
     /**
-     * Setup method. Must be called before any other method is called
+     * Creates an additional led matrix (e.g. a brim band) with its own buffers & geometry
+     *
+     *     static LEDHat brim(MatrixGeometry::of<MatrixLayout<1, 64>>());
+     *     brim.setup<14>();
+     *
+     * @param[in] geometry Geometry of the led matrix, see MatrixGeometry::of()
+     */
+    explicit LEDHat(const MatrixGeometry &geometry);
+
+    LEDHat(const LEDHat &) = delete;
+    LEDHat &operator=(const LEDHat &) = delete;
+
+    /**
+     * Setup method of the hat. Must be called before any other method is called
      */
     void setup();
 
     /**
-     * Clears the the led matrix
+     * Setup method connecting the led matrix to the given pin. Must be called before any other method is called
+     *
+     * @tparam DATA_PIN The pin of the ESP32 where the led matrix is connected
+     */
+    template <uint8_t DATA_PIN>
+    void setup()
+    {
+        attach(FastLED.addLeds<NEOPIXEL, DATA_PIN>(_ledBuffers[0].data(), _geometry.numLeds()));
+    }
+
+    /**
+     * Shows the pixels of all led matrices
+     *
+     * The frames of all led matrices are transmitted at once, so the outputs are driven in parallel and the
+     * refresh time is bound by the longest chain instead of the sum. Blocks like show() if the previous
+     * transmission is still running.
+     */
+    static void showAll();
+
+    /**
+     * Gets all led matrices which are set up
+     */
+    static std::vector<LEDHat *> outputs();
+
+    /**
+     * Records every transmitted frame of all led matrices (e.g. to measure the frame rate of a script)
+     *
+     * In a host build the capture can also be selected by the environment variables LEDHAT_CAPTURE (file)
+     * and LEDHAT_PREVIEW (ANSI terminal preview).
+     *
+     * @param[in] capture The capture to record to, nullptr stops recording. Must live until it is replaced
+     */
+    static void setCapture(FrameCapture *capture);
+
+    /**
+     * Gets the number of rows of the led matrix
+     */
+    unsigned int rows() const { return _geometry.rows; }
+
+    /**
+     * Gets the number of columns of the led matrix
+     */
+    unsigned int cols() const { return _geometry.cols; }
+
+    /**
+     * Clears the the led matrix (the selected layer)
      */
     void clear();
 
+    /**
+     * Sets the width of the canvas all drawing routines write to
+     *
+     * The canvas can be wider than the led matrix (e.g. for long tickers or panoramas). Only the
+     * columns inside the viewport are shown. Wrap around of the drawing routines is done at the
+     * canvas width. Resizing clears the canvas and resets the viewport.
+     *
+     * @param[in] width Width in columns (at least the column count of the led matrix, at most MAX_CANVAS_WIDTH)
+     * @returns false if the layers would exceed MAX_CANVAS_PIXELS, the canvas is unchanged then
+     */
+    bool setCanvasWidth(unsigned int width);
+
+    /**
+     * Maximum width of the canvas, every layer allocates rows * width pixels
+     */
+    const static unsigned int MAX_CANVAS_WIDTH = 1024;
+
+    /**
+     * Maximum number of pixels of all layers together (layers * rows * canvas width), 48 KB as RGB pixels.
+     * One layer of the size of the led matrix is always allowed
+     */
+    const static unsigned int MAX_CANVAS_PIXELS = 16384;
+
+    /**
+     * Gets the width of the canvas
+     */
+    unsigned int canvasWidth() const { return _canvasWidth; }
+
+    /**
+     * Sets the first canvas column shown on the led matrix
+     *
+     * The viewport wraps around at the end of the canvas. Moving it does not require any redraw.
+     *
+     * @param[in] offset Canvas column shown in the first column of the led matrix
+     */
+    void setViewport(int offset);
+
+    /**
+     * Gets the first canvas column shown on the led matrix
+     */
+    unsigned int viewport() const { return _viewport; }
+
+    /**
+     * Sets the number of layers
+     *
+     * Every layer has its own canvas which keeps its content until it is drawn again. On show() the
+     * layers are composed from bottom (layer 0) to top. New layers are empty and use BlendMode::Replace.
+     *
+     * @param[in] count Number of layers (at least 1, at most MAX_LAYERS)
+     * @returns false if the layers would exceed MAX_CANVAS_PIXELS, the layers are unchanged then
+     */
+    bool setLayerCount(unsigned int count);
+
+    /**
+     * Maximum number of layers
+     */
+    const static unsigned int MAX_LAYERS = 8;
+
+    /**
+     * Gets the number of layers
+     */
+    unsigned int layerCount() const { return _layers.size(); }
+
+    /**
+     * Selects the layer all drawing routines (including clear) write to
+     *
+     * @param[in] layer Index of the layer
+     */
+    void selectLayer(unsigned int layer);
+
+    /**
+     * Sets the opacity of a layer
+     *
+     * @param[in] layer Index of the layer
+     * @param[in] opacity 0 (invisible) - 255 (opaque)
+     */
+    void setLayerOpacity(unsigned int layer, uint8_t opacity);
+
+    /**
+     * Sets how a layer is combined with the layers below
+     *
+     * @param[in] layer Index of the layer
+     * @param[in] mode The blend mode
+     */
+    void setLayerBlendMode(unsigned int layer, BlendMode mode);
+
+    /**
+     * Switches a layer between RGB pixels and 8-bit palette indices. Switching clears the layer.
+     *
+     * An indexed layer stores one palette index per pixel which is expanded through the palette on show().
+     * Animating the palette (e.g. rotatePalette()) then changes all pixels without redrawing them.
+     * Colors drawn into an indexed layer are mapped to the closest palette entry.
+     *
+     * @param[in] layer Index of the layer
+     * @param[in] indexed true for palette indices, false for RGB pixels
+     */
+    void setLayerIndexed(unsigned int layer, bool indexed);
+
+    /**
+     * Sets the color of a palette entry
+     *
+     * @param[in] index Index of the palette entry
+     * @param[in] color The new color
+     */
+    void setPaletteColor(uint8_t index, CRGB color);
+
+    /**
+     * Gets the color of a palette entry
+     *
+     * @param[in] index Index of the palette entry
+     */
+    CRGB paletteColor(uint8_t index) const { return _palette[index]; }
+
+    /**
+     * Rotates the palette entries in the given range (color cycling)
+     *
+     * @param[in] steps Number of entries to rotate by. Entry i gets the color of entry i - steps
+     * @param[in] first First entry of the range
+     * @param[in] last Last entry of the range
+     */
+    void rotatePalette(int steps, uint8_t first = 0, uint8_t last = 255);
+
+    /**
+     * Fills the palette entries in the given range with a linear gradient
+     *
+     * @param[in] first First entry of the range (gets color from)
+     * @param[in] last Last entry of the range (gets color to)
+     * @param[in] from Color of the first entry
+     * @param[in] to Color of the last entry
+     */
+    void fillPaletteGradient(uint8_t first, uint8_t last, CRGB from, CRGB to);
+
     /**
      * Prints the given character at given position. Wrap around automatically.
      *
@@ -51,20 +357,150 @@ public:
      * @param[in] row Row where to start printing character
      * @param[in] col Column where to start printing character
      * @param[in] color The color which the character pixels will have
-     * @param[in] maxWrapAround Maximum column until which a character is allowed to be printed after wrap around
+     * @param[in] maxWrapAround Maximum column until which a character is allowed to be printed after wrap around (negative = no wrap around)
      */
-    void drawCharacter(const Character &c, int row, int col, CRGB color, int maxWrapAround = 0);
+    void drawCharacter(const Character &c, int row, int col, CRGB color, int maxWrapAround = -1);
 
     /**
      * Draws the given text onto the led buffer on given position. (does not flush the leds)
      *
+     * The text is UTF-8 encoded, characters missing in the font are drawn as box.
+     * The characters are placed proportionally, see setTracking(), setKerning() & setMonospace().
+     * Anti-aliased fonts (see tools/generateCharacters.py) are blended with the pixels below by their coverage.
+     *
+     * @param[in] text The text to be drawn
+     * @param[in] color The color in which the text should be drawn
+     * @param[in] offsetX Start colum position of the text
+     * @param[in] offsetY Start row position of the text
+     * @param[in] allowWrapAround Defines if a wrap around is allowed
+     * @param[in] font The font of the text
+     */
+    void drawText(const char *text, CRGB color, int offsetX = 0, int offsetY = 0, bool allowWrapAround = true,
+                  const Font &font = Font::builtin());
+
+    /**
+     * Draws the given text like drawText(), but with colors changing per character or column
+     *
+     * The colors are computed while the glyphs are drawn, so a rainbow ticker is one call per frame.
+     *
+     * @param[in] text The text to be drawn
+     * @param[in] colors The colors of the text
+     * @param[in] offsetX Start colum position of the text
+     * @param[in] offsetY Start row position of the text
+     * @param[in] allowWrapAround Defines if a wrap around is allowed
+     * @param[in] font The font of the text
+     */
+    void drawText(const char *text, const TextColors &colors, int offsetX = 0, int offsetY = 0, bool allowWrapAround = true,
+                  const Font &font = Font::builtin());
+
+    /**
+     * Draws the given text like drawText(), but from a cache of pre-rasterized texts
+     *
+     * The text is rasterized on the first call and kept in a small cache. Following calls with the same
+     * text (e.g. scrolling it by changing the offset) only copy the visible columns of the cached strip.
+     *
      * @param[in] text The text to be drawn
      * @param[in] color The color in which the text should be drawn
      * @param[in] offsetX Start colum position of the text
      * @param[in] offsetY Start row position of the text
      * @param[in] allowWrapAround Defines if a wrap around is allowed
+     * @param[in] font The font of the text
+     */
+    void drawCachedText(const char *text, CRGB color, int offsetX = 0, int offsetY = 0, bool allowWrapAround = true,
+                        const Font &font = Font::builtin());
+
+    /**
+     * Sets the blank columns between two characters of a text (default 1)
+     *
+     * @param[in] tracking Columns between two characters, may be negative
+     */
+    void setTracking(int tracking);
+
+    /**
+     * Adjusts the gap between two specific characters (e.g. -1 for "AV" or "Te")
+     *
+     * @param[in] left Codepoint of the first character of the pair
+     * @param[in] right Codepoint of the second character of the pair
+     * @param[in] adjustment Columns added to the gap (0 removes the pair)
+     */
+    void setKerning(uint32_t left, uint32_t right, int adjustment);
+
+    /**
+     * Draws texts in the fixed cells of the font instead of proportionally (no tracking & kerning)
+     *
+     * @param[in] monospace Use fixed cells
+     */
+    void setMonospace(bool monospace);
+
+    /**
+     * Measures the width of the given text as drawn by drawText(). Only the widths of the characters are looked up
+     *
+     * @param[in] text The text to measure
+     * @param[in] font The font of the text
+     * @returns The width in columns
+     */
+    unsigned int measureText(const char *text, const Font &font = Font::builtin()) const;
+
+    /**
+     * Draws the given text aligned inside a box of columns (no wrap around)
+     *
+     * @param[in] text The text to be drawn
+     * @param[in] color The color in which the text should be drawn
+     * @param[in] left First column of the box
+     * @param[in] width Number of columns of the box
+     * @param[in] align Alignment of the text inside the box
+     * @param[in] overflow Handling of a text wider than the box
+     * @param[in] offsetY Start row position of the text
+     * @param[in] font The font of the text
+     */
+    void drawAlignedText(const char *text, CRGB color, int left, int width, TextAlign align = TextAlign::Left,
+                         TextOverflow overflow = TextOverflow::Clip, int offsetY = 0, const Font &font = Font::builtin());
+
+    /**
+     * Scrolls the given text through the led matrix (marquee) until stopScroll() is called
+     *
+     * The text enters on the right and leaves on the left, then it starts over. The position follows the time
+     * since this call, so the speed does not depend on how often update() is called. Between two columns the
+     * text is blended into both (sub-column smoothing). The marquee owns the rows of the text on the selected
+     * layer, they are cleared on every frame. Select a layer of its own to scroll over other content.
+     *
+     * @param[in] text The text to scroll
+     * @param[in] color The color of the text
+     * @param[in] speed Columns per second, negative values scroll to the right
+     * @param[in] offsetY Start row position of the text
+     * @param[in] font The font of the text, copied
+     */
+    void scroll(const char *text, CRGB color, float speed, int offsetY = 0, const Font &font = Font::builtin());
+
+    /**
+     * Stops the marquee started by scroll(). The text stays where it is
+     */
+    void stopScroll();
+
+    /**
+     * Checks if a marquee is running
+     */
+    bool isScrolling() const { return _marquee.active; }
+
+    /**
+     * Advances the marquee to the current time & shows the frame without blocking (see showAsync()).
+     * Call it from the main loop, it does nothing if no marquee is running.
+     */
+    void update();
+
+    /**
+     * Draws a frame of the given sprite onto the led buffer. Transparent pixels keep the pixels below
+     *
+     * The runs of the sprite are decoded straight into column masks. Rows outside the led matrix are clipped,
+     * columns exceeding the canvas are wrapped around to the other side (the hat is a cylinder).
+     *
+     * @param[in] sprite The sprite to draw
+     * @param[in] offsetX Column of the left sprite column
+     * @param[in] offsetY Row of the top sprite row
+     * @param[in] frame Frame of the sprite to draw
+     * @param[in] allowWrapAround Defines if a wrap around is allowed. Otherwise the columns are clipped
      */
-    void drawText(const char *text, CRGB color, int offsetX = 0, int offsetY = 0, bool allowWrapAround = true);
+    void drawSprite(const Sprite &sprite, int offsetX, int offsetY, unsigned int frame = 0, bool allowWrapAround = true);
 
     /**
      * Sets the color of given pixel
@@ -75,6 +511,15 @@ public:
      */
     void setPixel(int y, int x, CRGB color);
 
+    /**
+     * Sets the palette index of given pixel. On a RGB layer the color of the palette entry is set.
+     *
+     * @param[in] y y-Position of pixel
+     * @param[in] x x-Position of pixel
+     * @param[in] index Index of the palette entry
+     */
+    void setPixelIndex(int y, int x, uint8_t index);
+
     /**
      * Gets the current color of given pixel
      * 
@@ -83,54 +528,647 @@ public:
      */
     CRGB getPixel(int y, int x);
 
+    /**
+     * Fills a rectangle with the given color. Parts outside the canvas are clipped
+     *
+     * @param[in] row Top row of the rectangle
+     * @param[in] col Left column of the rectangle
+     * @param[in] height Number of rows
+     * @param[in] width Number of columns
+     * @param[in] color Color of the rectangle
+     */
+    void fillRect(int row, int col, int height, int width, CRGB color);
+
+    /**
+     * Draws a horizontal line
+     *
+     * @param[in] row Row of the line
+     * @param[in] col Left column of the line
+     * @param[in] width Number of columns
+     * @param[in] color Color of the line
+     */
+    void drawHLine(int row, int col, int width, CRGB color) { fillRect(row, col, 1, width, color); }
+
+    /**
+     * Draws a vertical line (e.g. a bar of a VU meter)
+     *
+     * @param[in] row Top row of the line
+     * @param[in] col Column of the line
+     * @param[in] height Number of rows
+     * @param[in] color Color of the line
+     */
+    void drawVLine(int row, int col, int height, CRGB color) { fillRect(row, col, height, 1, color); }
+
+    /**
+     * Largest coordinate (in both directions) & radius accepted by drawLine(), drawCircle() & fillRadialGradient().
+     * Shapes exceeding it are not drawn
+     */
+    const static int MAX_COORDINATE = 16384;
+
+    /**
+     * Draws a line between two pixels (Bresenham). Parts outside the canvas are clipped
+     *
+     * Every pixel is computed from its step along the longer axis, so only the steps on the canvas are visited.
+     *
+     * @param[in] row0 Row of the start pixel
+     * @param[in] col0 Column of the start pixel
+     * @param[in] row1 Row of the end pixel
+     * @param[in] col1 Column of the end pixel
+     * @param[in] color Color of the line
+     */
+    void drawLine(int row0, int col0, int row1, int col1, CRGB color);
+
+    /**
+     * Draws a circle (midpoint algorithm). Parts outside the canvas are clipped
+     *
+     * @param[in] row Row of the center
+     * @param[in] col Column of the center
+     * @param[in] radius Radius in pixels
+     * @param[in] color Color of the circle
+     * @param[in] filled Fill the circle instead of drawing the outline only
+     */
+    void drawCircle(int row, int col, int radius, CRGB color, bool filled = false);
+
+    /**
+     * Fills a rectangle with a linear gradient
+     *
+     * @param[in] row Top row of the rectangle
+     * @param[in] col Left column of the rectangle
+     * @param[in] height Number of rows
+     * @param[in] width Number of columns
+     * @param[in] from Color of the left column (top row if vertical)
+     * @param[in] to Color of the right column (bottom row if vertical)
+     * @param[in] vertical Run the gradient from top to bottom instead of left to right
+     */
+    void fillGradient(int row, int col, int height, int width, CRGB from, CRGB to, bool vertical = false);
+
+    /**
+     * Fills a circle with a radial gradient
+     *
+     * @param[in] row Row of the center
+     * @param[in] col Column of the center
+     * @param[in] radius Radius in pixels
+     * @param[in] inner Color of the center
+     * @param[in] outer Color of the border
+     */
+    void fillRadialGradient(int row, int col, int radius, CRGB inner, CRGB outer);
+
     /**
      * Shows the pixels on th LEDHat
+     *
+     * Composes the changed columns of the layers inside the viewport, runs the output stage (gamma, brightness,
+     * dithering) fused with the remap into the physical wiring order and hands the frame to the
+     * output task. If the previous frame is still being transmitted this call blocks until it is done,
+     * so no frame is lost. Rendering of the next frame can start as soon as this call returns.
+     * If no pixel changed since the last transmission nothing is transmitted at all.
      */
     void show();
 
+    /**
+     * Shows the pixels on the LEDHat without blocking
+     *
+     * Same as show(), but if the output task is still busy with the previous frame the current frame
+     * is dropped instead of waiting.
+     *
+     * @returns true if the frame was handed to the output task, false if it was dropped
+     */
+    bool showAsync();
+
+    /**
+     * Sets the gamma of every color channel used by the output stage
+     *
+     * Drawing routines work with linear colors, the gamma correction is applied on show().
+     * A gamma of 1.0 (default) leaves the colors unchanged, 2.2 - 2.8 matches WS2812 leds.
+     *
+     * @param[in] red Gamma of the red channel
+     * @param[in] green Gamma of the green channel
+     * @param[in] blue Gamma of the blue channel
+     */
+    void setGamma(float red, float green, float blue);
+
+    /**
+     * Sets the master brightness applied on show()
+     *
+     * @param[in] brightness 0 (off) - 255 (full)
+     */
+    void setBrightness(uint8_t brightness);
+
+    /**
+     * Fades the master brightness linearly to the given value. The fade advances with every show()
+     *
+     * @param[in] brightness Brightness at the end of the fade
+     * @param[in] duration Duration of the fade in milliseconds
+     */
+    void fadeBrightness(uint8_t brightness, unsigned long duration);
+
+    /**
+     * Gets the current master brightness (including a running fade)
+     */
+    uint8_t currentBrightness() const;
+
+    /**
+     * Enables temporal dithering (default disabled)
+     *
+     * Gamma & brightness are computed with 8 fractional bits. With dithering the fraction is
+     * recovered over multiple frames, which removes the banding of dark fades. The dither pattern
+     * changes every frame, so a frame with fractions is transmitted on every show() even if
+     * nothing changed.
+     *
+     * @param[in] enabled true to enable dithering
+     */
+    void setDithering(bool enabled);
+
+    /**
+     * Sets the maximum current the led matrix may draw
+     *
+     * The current of the shown frame is estimated (updated incrementally for changed columns only).
+     * If it exceeds the budget the brightness is scaled down on show().
+     *
+     * @param[in] milliamps Current budget in mA (0 = unlimited)
+     */
+    void setPowerBudget(unsigned int milliamps);
+
+    /**
+     * Gets the estimated current of the last shown frame in mA (after limiting)
+     */
+    unsigned int estimatedCurrent() const { return _estimatedCurrent; }
+
+    /**
+     * Gets the brightness scale applied by the power limit on the last show(): 255 = not limited
+     */
+    uint8_t powerScale() const { return _powerScale; }
+
+    /**
+     * Gets the number of frames dropped by showAsync() because the output was still busy
+     */
+    unsigned int droppedFrames() const { return _droppedFrames; }
+
+    /**
+     * Gets the number of frames handed to the output task
+     */
+    unsigned int sentFrames() const { return _sentFrames; }
+
+    /**
+     * Gets the number of frames not transmitted because nothing changed since the last transmission
+     */
+    unsigned int skippedFrames() const { return _skippedFrames; }
+
 private:
-    LEDHat() = default;
+    /**
+     * Registers the FastLED controller of this led matrix & starts the output task with the first one
+     *
+     * @param[in] controller The controller driving the led matrix
+     */
+    void attach(CLEDController &controller);
+
+    /**
+     * A layer with its own canvas
+     */
+    struct Layer
+    {
+        std::vector<CRGB> pixels;     ///< canvas of a RGB layer
+        std::vector<uint8_t> indices; ///< canvas of an indexed layer
+        bool indexed = false;
+        uint8_t opacity = 255;
+        BlendMode mode = BlendMode::Replace;
+    };
+
+    /**
+     * Gets the selected layer
+     */
+    Layer &activeLayer() { return _layers[_activeLayer]; }
+
+    /**
+     * Sizes the canvas of a layer to the canvas width. Existing content is kept
+     */
+    void allocateLayer(Layer &layer);
+
+    /**
+     * Invalidates everything depending on the palette
+     */
+    void paletteChanged();
+
+    /**
+     * Gets the palette entry closest to the given color. The last lookup is cached, so drawing
+     * with one color costs one search per call.
+     *
+     * @param[in] color The color to look up
+     * @returns Index of the closest palette entry
+     */
+    uint8_t paletteIndexOf(CRGB color);
+
+    /**
+     * Composes one canvas column of all layers using 8-bit fixed point math
+     *
+     * @param[in] col Column on the canvas
+     * @param[out] out One composed pixel per row
+     */
+    void composeColumn(unsigned int col, CRGB *out) const;
+
+    /**
+     * Renders the frame & hands it to the output task
+     *
+     * @param[in] wait Wait for the output task if it is busy. Otherwise the frame is dropped without rendering it
+     * @returns true if the frame was handed to the output task (or nothing had to be transmitted)
+     */
+    bool submitFrame(bool wait);
+
+    /**
+     * Checks if the output task is transmitting
+     */
+    static bool isOutputBusy();
+
+    /**
+     * Composes the viewport of the layers & runs the output stage into the back buffer
+     *
+     * @returns The rendered frame or nullptr if it does not have to be transmitted (unchanged)
+     */
+    CRGB *renderFrame();
+
+    /**
+     * Hands the rendered frame to the output task. Must be called with the output mutex locked
+     *
+     * @param[in] frame The frame returned by renderFrame()
+     */
+    void queueFrame(CRGB *frame);
+
+    /**
+     * Output stage: applies gamma, brightness & dithering to the composed pixels in one pass and
+     * writes them in physical wiring order
+     *
+     * @param[out] frame The led buffer to fill
+     * @param[in] brightness The master brightness
+     */
+    void renderOutput(CRGB *frame, uint8_t brightness);
+
+    /**
+     * Updates the power estimate with a newly composed column
+     *
+     * @param[in] col Column on the led matrix
+     */
+    void updateColumnPower(unsigned int col);
+
+    /**
+     * Scales the brightness down so the estimated current stays within the power budget
+     *
+     * @param[in] brightness The requested master brightness
+     * @returns The brightness to use for the output
+     */
+    uint8_t limitBrightness(uint8_t brightness);
+
+    /**
+     * Reverses the bit order of a byte
+     */
+    static uint8_t reverseBits(uint8_t value);
+
+    /**
+     * Generates the gamma lookup tables (8.8 fixed point) of all color channels
+     */
+    static std::array<std::array<uint16_t, 256>, 3> makeGammaTables(float red, float green, float blue);
 
     /**
-     * Computes the row & column on the led matrix given the index in the linear led buffer
+     * Body of the output task. Transmits the submitted frames of all led matrices at once
+     */
+    static void outputLoop();
+
+    /**
+     * Computes the index in the logical canvas given the row & column on the canvas
+     *
+     * The canvas is stored column-major, so all pixels of one column are contiguous in memory.
      *
-     * @param[in] idx Index in the linear led buffer
-     * @param[out] row Row on the led matrix
-     * @param[out] col Column on the led matrix
+     * @param[in] row Row on the canvas
+     * @param[in] col Column on the canvas
+     * @return Index in the canvas
      */
-    void indexToCoordinate(unsigned int idx, unsigned int &row, unsigned int &col);
+    unsigned int canvasIndex(unsigned int row, unsigned int col) const;
 
     /**
-     * Computes the index in the linear led buffer given the row & column on the led matrix
+     * Draws columns given as bit masks with the wrap around rules of drawCharacter()
      *
-     * @param[in] row Row on led matrix
-     * @param[in] col Column on led matrix
-     * @return Index in the linear led buffer
+     * The visible column range is computed once, afterwards every column is written from its mask.
+     * Anti-aliased columns (more than 1 coverage bit) are blended into the canvas instead, see blendColumn().
+     *
+     * @param[in] columns Column bit masks (bit n = row n) or coverage columns, see glyphColumn()
+     * @param[in] bits Coverage bits per pixel
+     * @param[in] width Number of columns
+     * @param[in] row Row of bit 0
+     * @param[in] col Column of the first mask
+     * @param[in] color The color of the set pixels
+     * @param[in] maxWrapAround Maximum column until which is drawn after wrap around (negative = no wrap around)
+     */
+    void drawColumns(const uint8_t *columns, unsigned int bits, int width, int row, int col, CRGB color, int maxWrapAround);
+
+    /**
+     * Draws columns like drawColumns(), but with a color per column
+     *
+     * @param[in] colorAt Callable returning the color of a column given its index & its column on the canvas
+     */
+    template <typename ColorAt>
+    void drawColumns(const uint8_t *columns, unsigned int bits, int width, int row, int col, ColorAt colorAt, int maxWrapAround);
+
+    /**
+     * Draws the glyphs of a text with spacing, kerning & wrap around, the loop shared by both drawText()
+     *
+     * @param[in] glyphColor Callable returning the color of a glyph column given the index of the character,
+     *                       the canvas column of the glyph, the column in the glyph & its column on the canvas
+     */
+    template <typename GlyphColor>
+    void drawGlyphs(const char *text, int offsetX, int offsetY, bool allowWrapAround, const Font &font, GlyphColor glyphColor);
+
+    /**
+     * Sets the pixels of one canvas column given by a bit mask
+     *
+     * @param[in] col Column on the canvas
+     * @param[in] mask Bit n set = pixel in row n gets the color
+     * @param[in] color The color of the set pixels
+     */
+    void writeColumn(unsigned int col, uint32_t mask, CRGB color);
+
+    /**
+     * Blends the color into one canvas column using the coverage of every pixel as alpha (8-bit fixed point)
+     *
+     * Blending works on the linear colors of the canvas, so the edges keep their weight after the gamma correction.
+     * Pixels outside the led matrix are clipped.
+     *
+     * @param[in] col Column on the canvas
+     * @param[in] coverage Coverage of the pixels, bits per row (row 0 in the lowest bits)
+     * @param[in] bits Coverage bits per pixel (2 or 4)
+     * @param[in] row Row of the first pixel
+     * @param[in] color The color of fully covered pixels
+     */
+    void blendColumn(unsigned int col, uint32_t coverage, unsigned int bits, int row, CRGB color);
+
+    /**
+     * Draws the marquee at the given position into its rows, every column mixes the two text columns covering it
+     *
+     * @param[in] strip The rasterized text of the marquee
+     * @param[in] position Scrolled distance in 1/256 columns since the text started to enter the led matrix
+     */
+    void renderMarquee(const TextStrip &strip, int64_t position);
+
+    /**
+     * Checks if a coordinate of a shape lies within +/- MAX_COORDINATE
+     */
+    static bool isInRange(int value);
+
+    /**
+     * Checks if the layers fit into MAX_CANVAS_PIXELS
+     *
+     * @param[in] width Canvas width in columns
+     * @param[in] layers Number of layers
+     */
+    bool fitsCanvas(unsigned int width, unsigned int layers) const;
+
+    /**
+     * Gets the column bit mask of the rows top..bottom clipped to the led matrix
+     *
+     * @param[in] top First row of the span
+     * @param[in] bottom Last row of the span
+     * @returns The bit mask (bit n = row n), 0 if the span lies outside
+     */
+    uint32_t rowSpan(int top, int bottom) const;
+
+    /**
+     * Marks the given column as changed since the last transmission
+     *
+     * @param[in] col Column on the canvas
+     */
+    void markDirty(unsigned int col);
+
+    /**
+     * Marks all columns of the led matrix as changed
+     */
+    void markAllDirty();
+
+    /**
+     * The pin of the ESP32 where the hat is connected, see HatConfig.h
+     */
+    const static uint8_t PIN = LEDHAT_PIN;
+
+    /**
+     * Maximum number of rows supported by the column bit masks
+     */
+    const static unsigned int MAX_ROWS = 32;
+
+    /**
+     * Geometry of the led matrix including the compile-time generated led tables
+     */
+    const MatrixGeometry _geometry;
+
+    /**
+     * Width of the canvas in columns
+     */
+    unsigned int _canvasWidth;
+
+    /**
+     * First canvas column shown on the led matrix
+     */
+    unsigned int _viewport = 0;
+
+    /**
+     * The layers, each with a logical canvas (column-major, independent of the wiring)
+     */
+    std::vector<Layer> _layers = std::vector<Layer>(1);
+
+    /**
+     * Index of the layer all drawing routines write to
+     */
+    unsigned int _activeLayer = 0;
+
+    /**
+     * Number of palette entries
+     */
+    const static unsigned int PALETTE_SIZE = 256;
+
+    /**
+     * Generates the default palette (gray ramp, entry 0 is black)
+     */
+    static std::array<CRGB, PALETTE_SIZE> makeDefaultPalette();
+
+    /**
+     * The palette used by indexed layers
+     */
+    std::array<CRGB, PALETTE_SIZE> _palette = makeDefaultPalette();
+
+    /**
+     * Cache of the last paletteIndexOf() lookup
+     */
+    CRGB _paletteLookupColor;
+    uint8_t _paletteLookupIndex = 0;
+    bool _paletteLookupValid = false;
+
+    /**
+     * Number of rasterized texts kept for drawCachedText()
+     */
+    const static unsigned int TEXT_STRIP_CACHE_SIZE = 4;
+
+    /**
+     * Cache of rasterized texts for drawCachedText()
+     */
+    TextStripCache _textStrips{TEXT_STRIP_CACHE_SIZE};
+
+    /**
+     * Spacing between the characters of drawn texts
+     */
+    TextSpacing _spacing;
+
+    /**
+     * Text scrolled by update(), see scroll()
+     */
+    struct Marquee
+    {
+        bool active = false;
+        std::string text;
+        CRGB color;
+        int32_t speed = 0; ///< 1/256 columns per second
+        int offsetY = 0;
+        Font font; ///< copy, the font of a script may be collected while the text scrolls
+        unsigned int layer = 0;
+        unsigned long start = 0; ///< millis() when scrolling started
+        int64_t position = -1;   ///< position of the last rendering, -1 = not rendered
+    };
+
+    Marquee _marquee;
+
+    /**
+     * One flag per column of the led matrix which changed since the last transmission
+     */
+    std::vector<bool> _dirtyColumns;
+
+    /**
+     * At least one column is dirty
+     */
+    bool _anyDirty = true;
+
+    /**
+     * The layers composed inside the viewport (column-major, linear colors). Only dirty columns are recomposed
+     */
+    std::vector<CRGB> _composed;
+
+    /**
+     * Gamma lookup tables per color channel (8.8 fixed point)
+     */
+    std::array<std::array<uint16_t, 256>, 3> _gamma = makeGammaTables(1.0f, 1.0f, 1.0f);
+
+    /**
+     * Master brightness fade. Without fade from & to are equal
+     */
+    uint8_t _fadeFrom = 255;
+    uint8_t _fadeTo = 255;
+    unsigned long _fadeStart = 0;
+    unsigned long _fadeDuration = 0;
+
+    /**
+     * Brightness of the last transmitted frame
+     */
+    uint8_t _outputBrightness = 255;
+
+    /**
+     * Temporal dithering state
+     */
+    bool _dithering = false;
+    bool _ditherPending = false; ///< last frame had dithered pixels, so unchanged frames are still sent
+    uint8_t _ditherFrame = 0;
+
+    /**
+     * Current of one led per color channel at full brightness and of a dark led in mA (WS2812B)
+     */
+    const static unsigned int RED_MILLIAMPS = 16;
+    const static unsigned int GREEN_MILLIAMPS = 11;
+    const static unsigned int BLUE_MILLIAMPS = 15;
+    const static unsigned int IDLE_MILLIAMPS = 1;
+
+    /**
+     * Sum of the gamma corrected channel values per column and of the whole composed frame
+     */
+    std::vector<std::array<uint16_t, 3>> _columnSums;
+    uint32_t _channelSums[3] = {};
+
+    /**
+     * Power budget in mA (0 = unlimited)
+     */
+    unsigned int _powerBudget = 0;
+
+    /**
+     * Power telemetry of the last show()
+     */
+    unsigned int _estimatedCurrent = 0;
+    uint8_t _powerScale = 255;
+
+    /**
+     * The output has to be rendered & transmitted even without dirty columns (e.g. a composed frame was dropped)
+     */
+    bool _outputPending = false;
+
+    /**
+     * The last frame was handed to the output task, so the leds show it. Before that the unchanged frame check is skipped
+     */
+    bool _lastFrameSent = false;
+
+    /**
+     * Front & back led buffers in physical wiring order. One is transmitted while the other is filled on show()
+     */
+    std::vector<CRGB> _ledBuffers[2];
+
+    /**
+     * Index of the buffer which is filled on the next show()
+     */
+    unsigned int _backBuffer = 0;
+
+    /**
+     * The FastLED controller driving the led matrix
+     */
+    CLEDController *_controller = nullptr;
+
+    /**
+     * Frame waiting for the output task. nullptr if there is no new frame
+     */
+    CRGB *_outputFrame = nullptr;
+
+    /**
+     * Duration of rendering the last frame in micros
+     */
+    unsigned long _renderMicros = 0;
+
+    /**
+     * Render duration of the frame waiting for or in transmission (for the capture)
+     */
+    unsigned long _outputRenderMicros = 0;
+
+    /**
+     * Synchronisation between show() of all led matrices and the output task. Never destroyed, the output
+     * task waits on them until the program ends (destroying a waited on condition variable blocks on Linux)
+     */
+    static std::mutex &_outputMutex;
+    static std::condition_variable &_outputCondition;
+
+    /**
+     * The output task is transmitting
      */
-    int coordinateToIndex(int row, int col);
+    static bool _outputBusy;
 
     /**
-     * Total number of leds of the led matrix
+     * All led matrices which are set up
      */
-    const static unsigned int NUM_LEDS = 512;
+    static std::vector<LEDHat *> _outputs;
 
     /**
-     * Rows of the led matrix
+     * Capture recording the transmitted frames, nullptr if disabled
      */
-    const static unsigned int ROWS = 8;
+    static FrameCapture *_capture;
 
     /**
-     * Columns of the led matrix
+     * Number of frames dropped because the output task was still busy
      */
-    const static unsigned int COLS = NUM_LEDS / 8;
+    unsigned int _droppedFrames = 0;
 
     /**
-     * The pin of the ESP32 where the led matrix is connected
+     * Number of frames handed to the output task
      */
-    const static unsigned int PIN = 13;
+    unsigned int _sentFrames = 0;
 
     /**
-     * The led buffer containing the pixel values
+     * Number of frames skipped because nothing changed
      */
-    CRGB _ledBuffer[NUM_LEDS];
+    unsigned int _skippedFrames = 0;
 };
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+/**
+ * How the led strip runs through the matrix
+ */
+enum class Wiring {
+    Progressive, ///< every line starts on the same side
+    Serpentine,  ///< every second line runs in the opposite direction (zig-zag)
+};
+
+/**
+ * Direction of the lines the led strip runs along
+ */
+enum class Major {
+    Column, ///< the strip runs along the columns
+    Row,    ///< the strip runs along the rows
+};
+
+/**
+ * How the matrix is mounted relative to the logical coordinates
+ */
+enum class Mounting {
+    Normal,
+    FlipX,     ///< columns are mirrored
+    FlipY,     ///< rows are mirrored (upside down)
+    Rotate180, ///< columns & rows are mirrored
+};
+
+/**
+ * Compile-time layout policy of a led matrix
+ *
+ * The mapping of every logical pixel to its led is computed at compile time, so the index math of
+ * every variant is a single table lookup at runtime.
+ *
+ * @tparam ROWS_ Rows of the led matrix
+ * @tparam COLS_ Columns of the led matrix
+ * @tparam WIRING How the led strip runs through the matrix
+ * @tparam MAJOR Direction of the lines the led strip runs along
+ * @tparam MOUNTING How the matrix is mounted
+ */
+template <unsigned int ROWS_, unsigned int COLS_, Wiring WIRING = Wiring::Serpentine, Major MAJOR = Major::Column, Mounting MOUNTING = Mounting::Normal>
+struct MatrixLayout {
+    static constexpr unsigned int ROWS = ROWS_;
+    static constexpr unsigned int COLS = COLS_;
+    static constexpr unsigned int NUM_LEDS = ROWS * COLS;
+
+    /**
+     * Computes the index of the led given the row & column on the led matrix
+     */
+    static constexpr unsigned int ledIndex(unsigned int row, unsigned int col) {
+        if( MOUNTING == Mounting::FlipX || MOUNTING == Mounting::Rotate180 ) {
+            col = (COLS - 1) - col;
+        }
+        if( MOUNTING == Mounting::FlipY || MOUNTING == Mounting::Rotate180 ) {
+            row = (ROWS - 1) - row;
+        }
+
+        if( MAJOR == Major::Column ) {
+            const auto reversed = WIRING == Wiring::Serpentine && col % 2 == 1;
+            return col * ROWS + (reversed ? (ROWS - 1) - row : row);
+        }
+
+        const auto reversed = WIRING == Wiring::Serpentine && row % 2 == 1;
+        return row * COLS + (reversed ? (COLS - 1) - col : col);
+    }
+
+    /**
+     * Generates the table logical index (column-major: col * ROWS + row) -> led index
+     */
+    static constexpr std::array<uint16_t, NUM_LEDS> makeLedTable() {
+        std::array<uint16_t, NUM_LEDS> table{};
+        for( unsigned int col = 0; col < COLS; ++col ) {
+            for( unsigned int row = 0; row < ROWS; ++row ) {
+                table[col * ROWS + row] = ledIndex( row, col );
+            }
+        }
+        return table;
+    }
+
+    /**
+     * Logical index -> led index (stored in flash)
+     */
+    static constexpr std::array<uint16_t, NUM_LEDS> LED_TABLE = makeLedTable();
+
+    static_assert( NUM_LEDS <= 65536, "led index must fit into 16 bit" );
+    static_assert( ROWS >= 1 && ROWS <= 32, "the drawing routines keep one column in a 32 bit mask" );
+};
+
+/**
+ * Geometry of a led matrix as used at runtime, generated from a MatrixLayout
+ */
+struct MatrixGeometry {
+    unsigned int rows;
+    unsigned int cols;
+    const uint16_t* ledTable; ///< logical index (column-major) -> led index
+
+    /**
+     * Gets the geometry of the given layout policy
+     */
+    template <typename Layout>
+    static constexpr MatrixGeometry of() {
+        return { Layout::ROWS, Layout::COLS, Layout::LED_TABLE.data() };
+    }
+
+    unsigned int numLeds() const { return rows * cols; }
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include <FastLED.h>
+
+/**
+ * Small animated image stored as runs of palette indices
+ *
+ * The pixels of every frame are stored column by column (like the led matrix) as pairs of
+ * (run length, palette index), so drawing a sprite decodes whole runs into column masks.
+ * Palette index 0 is transparent, index n is the color palette[n - 1].
+ *
+ * In text form (sprite files & Lua) a pixel is one character:
+ * '.' or ' ' = transparent, '1'-'9' = 1-9, 'a'-'z' = 10-35, 'A'-'Z' = 36-61
+ *
+ *     palette ff0000 ffff00
+ *     frame
+ *     .11.
+ *     1221
+ *     .11.
+ *     frame
+ *     .22.
+ *     2112
+ *     .22.
+ */
+struct Sprite {
+    /**
+     * Palette index of transparent pixels
+     */
+    const static uint8_t TRANSPARENT = 0;
+
+    /**
+     * Maximum number of palette colors which can be written in text form
+     */
+    const static size_t MAX_COLORS = 61;
+
+    unsigned int width = 0;
+    unsigned int height = 0;
+    std::vector<CRGB> palette;
+
+    /**
+     * (run length, palette index) pairs of all frames
+     */
+    std::vector<uint8_t> runs;
+
+    /**
+     * Start of every frame in runs
+     */
+    std::vector<size_t> frames;
+
+    /**
+     * Gets the number of frames
+     */
+    unsigned int frameCount() const { return frames.size(); }
+
+    /**
+     * Encodes the given frames given in text form
+     *
+     * @param[in] palette Colors of the palette indices 1..n
+     * @param[in] frames Rows of every frame in text form. All frames must have the same size
+     * @param[out] sprite The encoded sprite
+     * @returns true if the frames are valid
+     */
+    static bool encode(const std::vector<CRGB>& palette, const std::vector<std::vector<std::string>>& frames, Sprite& sprite);
+
+    /**
+     * Parses a sprite file (see above)
+     *
+     * @param[in] text Content of the sprite file
+     * @param[out] sprite The encoded sprite
+     * @returns true if the file is valid
+     */
+    static bool parse(const std::string& text, Sprite& sprite);
+
+    /**
+     * Gets the palette index of given pixel character
+     *
+     * @returns The palette index or -1 if the character is no pixel
+     */
+    static int pixelIndex(char c);
+};
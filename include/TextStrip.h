@@ -0,0 +1,63 @@
+#pragma once
+#include <list>
+#include <string>
+#include <vector>
+
+#include "Font.h"
+
+/**
+ * A text rasterized once into one bit mask per column (bit n = row n) or coverage columns of an anti-aliased font
+ */
+struct TextStrip {
+    std::string text;
+    uint32_t font; ///< id of the font
+    unsigned int bits = 1; ///< coverage bits per pixel, see glyphColumn()
+    std::vector<uint8_t> columns; ///< bits bytes per column
+};
+
+/**
+ * Small least recently used cache of rasterized texts.
+ *
+ * Scrolling a text only changes its offset, so the strip is rasterized on the first frame and
+ * every following frame just copies the visible window of it.
+ */
+class TextStripCache {
+public:
+    /**
+     * @param[in] capacity Maximum number of strips kept in the cache
+     */
+    explicit TextStripCache(size_t capacity) : _capacity( capacity ) {}
+
+    /**
+     * Gets the strip of given text, rasterizing it if it is not cached yet
+     *
+     * The returned reference stays valid until the strip is evicted by later calls.
+     *
+     * @param[in] text The text to rasterize
+     * @param[in] font The font to rasterize the text with
+     * @param[in] spacing The spacing between the characters. Clear the cache if it changes
+     * @returns The rasterized text
+     */
+    const TextStrip& get(const char* text, const Font& font = Font::builtin(), const TextSpacing& spacing = TextSpacing());
+
+    /**
+     * Removes all strips (e.g. the spacing changed)
+     */
+    void clear() { _strips.clear(); }
+
+private:
+    /**
+     * Rasterizes the given text into the strip
+     */
+    static void rasterize(TextStrip& strip, const Font& font, const TextSpacing& spacing);
+
+    /**
+     * Maximum number of cached strips
+     */
+    size_t _capacity;
+
+    /**
+     * Cached strips, most recently used first
+     */
+    std::list<TextStrip> _strips;
+};
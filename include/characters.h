@@ -1,20 +1,138 @@
 #pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 typedef struct Character {
-    Character() : width(0), height(0), data(nullptr) {}
-    Character(unsigned int width, unsigned int height, const char* data) : width( width ), height( height ), data( data ) {}
+    Character() : width(0), height(0), columns(nullptr), leftBearing(0), rightBearing(0), bits(1) {}
+    Character(unsigned int width, unsigned int height, const uint8_t* columns, unsigned int leftBearing = 0, unsigned int rightBearing = 0,
+              unsigned int bits = 1)
+        : width( width ), height( height ), columns( columns ), leftBearing( leftBearing ), rightBearing( rightBearing ), bits( bits ) {}
 
+    /**
+     * Columns of the glyph without blank columns on the left & right
+     */
     unsigned int width;
     unsigned int height;
-    const char* data;
+
+    /**
+     * bits bytes per column, see glyphColumn(). With 1 bit per pixel bit n is set if the pixel in row n is lit
+     */
+    const uint8_t* columns;
+
+    /**
+     * Blank columns trimmed on the left & right of the glyph (the cell of the font is leftBearing + width + rightBearing)
+     */
+    unsigned int leftBearing;
+    unsigned int rightBearing;
+
+    /**
+     * Coverage bits per pixel: 1 for plain glyphs, 2 or 4 for anti-aliased glyphs (0 = blank, all bits set = lit)
+     */
+    unsigned int bits;
 } Character;
 
+/**
+ * Gets one column of glyph columns. Every column takes bits bytes (little endian), the pixel in row n
+ * is stored in the bits n * bits .. (n + 1) * bits - 1
+ *
+ * @param[in] columns The glyph columns
+ * @param[in] bits Coverage bits per pixel
+ * @param[in] x Index of the column
+ */
+inline uint32_t glyphColumn(const uint8_t* columns, unsigned int bits, unsigned int x) {
+    if( bits == 1 ) {
+        return columns[x];
+    }
+
+    uint32_t column = 0;
+    for( unsigned int i = 0; i < bits; ++i ) {
+        column |= uint32_t( columns[x * bits + i] ) << (8 * i);
+    }
+    return column;
+}
+
+/**
+ * Spacing between the glyphs of a text
+ *
+ * Glyphs are placed proportionally: every glyph is followed by the tracking plus the kerning of the
+ * pair. In monospace mode every glyph occupies its full cell like the font was designed.
+ */
+struct TextSpacing {
+    /**
+     * Blank columns between two glyphs
+     */
+    int tracking = 1;
+
+    /**
+     * Place the glyphs in their full cells (ignores tracking & kerning)
+     */
+    bool monospace = false;
+
+    /**
+     * Sets the adjustment of the gap between two specific characters (e.g. -1 for "AV")
+     *
+     * @param[in] left The first character of the pair
+     * @param[in] right The second character of the pair
+     * @param[in] adjustment Columns added to the gap (0 removes the pair)
+     */
+    void setKerning(uint32_t left, uint32_t right, int adjustment);
+
+    /**
+     * Gets the adjustment of the gap between two characters
+     */
+    int kerning(uint32_t left, uint32_t right) const;
+
+    /**
+     * Gets the column of the glyph relative to its position in the text
+     */
+    int offset(const Character& character) const { return monospace ? character.leftBearing : 0; }
+
+    /**
+     * Gets the columns from the position of a glyph to the position of the next one
+     *
+     * @param[in] character The glyph
+     * @param[in] c The codepoint of the glyph
+     * @param[in] next The following codepoint (0 at the end of the text, no gap is added)
+     */
+    int advance(const Character& character, uint32_t c, uint32_t next) const;
+
+    /**
+     * Kerning pairs (left << 32 | right, adjustment) sorted by pair
+     */
+    std::vector<std::pair<uint64_t, int8_t>> pairs;
+};
+
 /**
  * Gets the corresponding Character entry
  *
- * @param[in] c ASCII character
+ * ASCII is looked up directly, other codepoints in a sorted table. Codepoints missing in the font
+ * get the fallback glyph (a box).
+ *
+ * @param[in] codepoint Unicode codepoint of the character
  * @param[out] character Character entry
- * @returns bool Returns true if character entry was found. Otherwise false is returned
+ * @returns bool Returns true if character entry was found. Otherwise (control characters) false is returned
+ */
+bool getCharacter(uint32_t codepoint, Character& character);
+
+/**
+ * Gets the width of the corresponding Character entry without touching its columns
+ *
+ * @param[in] codepoint Unicode codepoint of the character
+ * @returns The width in columns or -1 if there is no character entry
+ */
+int getCharacterWidth(uint32_t codepoint);
+
+/**
+ * Codepoint returned for invalid UTF-8 sequences
  */
-bool getCharacter(const char c, Character& character);
+const uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
 
+/**
+ * Decodes the next codepoint of an UTF-8 text
+ *
+ * @param[in,out] text The text, advanced behind the decoded codepoint (not advanced at the end)
+ * @returns The codepoint or 0 at the end of the text. Invalid sequences (overlong, surrogates, beyond U+10FFFF,
+ *          truncated) give REPLACEMENT_CHARACTER, so only the terminating NUL gives 0
+ */
+uint32_t decodeUtf8(const char*& text);
@@ -1,98 +1,327 @@
-const char _text[] = "000000000000000000000000000000000000000000000000000110000001100000011000000000000001100000000000011001100110011000100100000000000000000000000000001001000111111000100100011111100010010000000000001111100110100000111100000101100111110000000000011001100100110000011000001100100110011000000000001111100011000110001101100011011010001111100000000000000110000001100000001000000000000000000000000000000011100011000001000000001100000000111000000000011100000000110000000010000011000111000000000000010010010001010100011111110001010100010010010000000000000110000001100001111110000110000001100000000000000000000000000000011000000110000000100000000000000000000000000001111110000000000000000000000000000000000000000000000000000110000001100000000000000001100000110000011000001100000110000000000000001111000110011001111110011001100011110000000000000110000011100000011000000110000111111000000000001111000000011000111100011000000111111000000000011111100000110000011100000001100111110000000000000001100110011001111110000001100000011000000000011111100110000000111100000001100111110000000000000110000011000001111100011001100011110000000000011111100000110000011000001100000110000000000000001111000110011000111100011001100011110000000000001111000110011000111100000110000011000000000000000000000001100000000000000110000000000000000000000000000001100000000000000110000000100000000000000001100001100001100000000110000000011000000000000000000111111000000000011111100000000000000000011000000001100000000110000110000110000000000000001111000110011000001100000110000001100000000000001111000101101001011010010010100011110000000000001111000110011001111110011001100110011000000000011111000110011001111100011001100111110000000000001111000110011001100000011001100011110000000000011111000110011001100110011001100111110000000000011111100110000001111000011000000111111000000000011111100110000001111000011000000110000000000000001111000110000001101110011001100011110000000000011001100110011001111110011001100110011000000000011111100001100000011000000110000111111000000000011111100000011000000110011001100011110000000000011001100110110001111000011011000110011000000000011000000110000001100000011000000111111000000000011000110011101110011010110011000110011000110000000000011001100111011001101110011001100110011000000000001111000110011001100110011001100011110000000000011111000110011001111100011000000110000000000000001111000110011001101110011001100011111000000000011111000110011001111100011001100110011000000000001111000110000000111100000001100011110000000000011111100001100000011000000110000001100000000000011001100110011001100110011001100011110000000000011001100110011001100110001111000001100000000000011000110011000110011010110011111110001101100000000000011001100011110000011000001111000110011000000000011001100011110000011000000110000001100000000000011111100000110000011000001100000111111000000000011111100110000001100000011000000111111000000000011000000011000000011000000011000000011000000000011111100000011000000110000001100111111000000000000110000011110001100110000000000000000000000000000000000000000000000000000000000111111000000000000110000001100000010000000000000000000000000000001111000110011001111110011001100110011000000000011111000110011001111100011001100111110000000000001111000110011001100000011001100011110000000000011111000110011001100110011001100111110000000000011111100110000001111000011000000111111000000000011111100110000001111000011000000110000000000000001111000110000001101110011001100011110000000000011001100110011001111110011001100110011000000000011111100001100000011000000110000111111000000000011111100000011000000110011001100011110000000000011001100110110001111000011011000110011000000000011000000110000001100000011000000111111000000000011000110011101110011010110011000110011000110000000000011001100111011001101110011001100110011000000000001111000110011001100110011001100011110000000000011111000110011001111100011000000110000000000000001111000110011001101110011001100011111000000000011111000110011001111100011001100110011000000000001111000110000000111100000001100011110000000000011111100001100000011000000110000001100000000000011001100110011001100110011001100011110000000000011001100110011001100110001111000001100000000000011000110011000110011010110011111110001101100000000000011001100011110000011000001111000110011000000000011001100011110000011000000110000001100000000000011111100000110000011000001100000111111000000000000111100001100001110000000110000001111000000000000110000001100000011000000110000001100000011000";
+const uint8_t _columns[] = {
+	0x00, 0x00, /*   */
+	0x17, 0x17, /* ! */
+	0x03, 0x07, 0x00, 0x00, 0x07, 0x03, /* " */
+	0x0a, 0x1f, 0x0a, 0x0a, 0x1f, 0x0a, /* # */
+	0x12, 0x17, 0x1d, 0x17, 0x1d, 0x09, /* $ */
+	0x13, 0x19, 0x0c, 0x06, 0x13, 0x19, /* % */
+	0x0a, 0x1f, 0x15, 0x19, 0x1d, 0x17, 0x0a, /* & */
+	0x03, 0x07, /* ' */
+	0x04, 0x0a, 0x0a, 0x11, 0x11, 0x11, /* ( */
+	0x11, 0x11, 0x11, 0x0a, 0x0a, 0x04, /* ) */
+	0x15, 0x0e, 0x04, 0x1f, 0x04, 0x0e, 0x15, /* * */
+	0x04, 0x04, 0x1f, 0x1f, 0x04, 0x04, /* + */
+	0x0c, 0x1c, /* , */
+	0x04, 0x04, 0x04, 0x04, 0x04, 0x04, /* - */
+	0x18, 0x18, /* . */
+	0x10, 0x18, 0x0c, 0x06, 0x03, 0x01, /* / */
+	0x0e, 0x1f, 0x15, 0x15, 0x1f, 0x0e, /* 0 */
+	0x10, 0x12, 0x1f, 0x1f, 0x10, 0x10, /* 1 */
+	0x18, 0x1d, 0x15, 0x15, 0x17, 0x12, /* 2 */
+	0x11, 0x11, 0x15, 0x17, 0x1f, 0x09, /* 3 */
+	0x06, 0x06, 0x04, 0x04, 0x1f, 0x1f, /* 4 */
+	0x13, 0x17, 0x15, 0x15, 0x1d, 0x09, /* 5 */
+	0x0c, 0x1e, 0x17, 0x15, 0x1c, 0x08, /* 6 */
+	0x11, 0x19, 0x0d, 0x07, 0x03, 0x01, /* 7 */
+	0x0a, 0x1f, 0x15, 0x15, 0x1f, 0x0a, /* 8 */
+	0x02, 0x17, 0x1d, 0x0d, 0x07, 0x02, /* 9 */
+	0x0a, 0x0a, /* : */
+	0x0a, 0x1a, /* ; */
+	0x04, 0x04, 0x0a, 0x0a, 0x11, 0x11, /* < */
+	0x0a, 0x0a, 0x0a, 0x0a, 0x0a, 0x0a, /* = */
+	0x11, 0x11, 0x0a, 0x0a, 0x04, 0x04, /* > */
+	0x02, 0x03, 0x19, 0x1d, 0x07, 0x02, /* ? */
+	0x0e, 0x11, 0x17, 0x1f, 0x11, 0x0e, /* @ */
+	0x1e, 0x1f, 0x05, 0x05, 0x1f, 0x1e, /* A */
+	0x1f, 0x1f, 0x15, 0x15, 0x1f, 0x0a, /* B */
+	0x0e, 0x1f, 0x11, 0x11, 0x1b, 0x0a, /* C */
+	0x1f, 0x1f, 0x11, 0x11, 0x1f, 0x0e, /* D */
+	0x1f, 0x1f, 0x15, 0x15, 0x11, 0x11, /* E */
+	0x1f, 0x1f, 0x05, 0x05, 0x01, 0x01, /* F */
+	0x0e, 0x1f, 0x11, 0x15, 0x1d, 0x0c, /* G */
+	0x1f, 0x1f, 0x04, 0x04, 0x1f, 0x1f, /* H */
+	0x11, 0x11, 0x1f, 0x1f, 0x11, 0x11, /* I */
+	0x09, 0x19, 0x11, 0x11, 0x1f, 0x0f, /* J */
+	0x1f, 0x1f, 0x04, 0x0e, 0x1b, 0x11, /* K */
+	0x1f, 0x1f, 0x10, 0x10, 0x10, 0x10, /* L */
+	0x1f, 0x1f, 0x02, 0x04, 0x02, 0x1f, 0x1f, /* M */
+	0x1f, 0x1f, 0x02, 0x04, 0x1f, 0x1f, /* N */
+	0x0e, 0x1f, 0x11, 0x11, 0x1f, 0x0e, /* O */
+	0x1f, 0x1f, 0x05, 0x05, 0x07, 0x02, /* P */
+	0x0e, 0x1f, 0x11, 0x15, 0x1f, 0x1e, /* Q */
+	0x1f, 0x1f, 0x05, 0x05, 0x1f, 0x1a, /* R */
+	0x02, 0x17, 0x15, 0x15, 0x1d, 0x08, /* S */
+	0x01, 0x01, 0x1f, 0x1f, 0x01, 0x01, /* T */
+	0x0f, 0x1f, 0x10, 0x10, 0x1f, 0x0f, /* U */
+	0x07, 0x0f, 0x18, 0x18, 0x0f, 0x07, /* V */
+	0x0f, 0x1f, 0x18, 0x0c, 0x18, 0x1f, 0x0f, /* W */
+	0x11, 0x1b, 0x0e, 0x0e, 0x1b, 0x11, /* X */
+	0x01, 0x03, 0x1e, 0x1e, 0x03, 0x01, /* Y */
+	0x11, 0x19, 0x1d, 0x17, 0x13, 0x11, /* Z */
+	0x1f, 0x1f, 0x11, 0x11, 0x11, 0x11, /* [ */
+	0x01, 0x03, 0x06, 0x0c, 0x18, 0x10, /* \ */
+	0x11, 0x11, 0x11, 0x11, 0x1f, 0x1f, /* ] */
+	0x04, 0x06, 0x03, 0x03, 0x06, 0x04, /* ^ */
+	0x10, 0x10, 0x10, 0x10, 0x10, 0x10, /* _ */
+	0x07, 0x03, /* ` */
+	0x1e, 0x1f, 0x05, 0x05, 0x1f, 0x1e, /* a */
+	0x1f, 0x1f, 0x15, 0x15, 0x1f, 0x0a, /* b */
+	0x0e, 0x1f, 0x11, 0x11, 0x1b, 0x0a, /* c */
+	0x1f, 0x1f, 0x11, 0x11, 0x1f, 0x0e, /* d */
+	0x1f, 0x1f, 0x15, 0x15, 0x11, 0x11, /* e */
+	0x1f, 0x1f, 0x05, 0x05, 0x01, 0x01, /* f */
+	0x0e, 0x1f, 0x11, 0x15, 0x1d, 0x0c, /* g */
+	0x1f, 0x1f, 0x04, 0x04, 0x1f, 0x1f, /* h */
+	0x11, 0x11, 0x1f, 0x1f, 0x11, 0x11, /* i */
+	0x09, 0x19, 0x11, 0x11, 0x1f, 0x0f, /* j */
+	0x1f, 0x1f, 0x04, 0x0e, 0x1b, 0x11, /* k */
+	0x1f, 0x1f, 0x10, 0x10, 0x10, 0x10, /* l */
+	0x1f, 0x1f, 0x02, 0x04, 0x02, 0x1f, 0x1f, /* m */
+	0x1f, 0x1f, 0x02, 0x04, 0x1f, 0x1f, /* n */
+	0x0e, 0x1f, 0x11, 0x11, 0x1f, 0x0e, /* o */
+	0x1f, 0x1f, 0x05, 0x05, 0x07, 0x02, /* p */
+	0x0e, 0x1f, 0x11, 0x15, 0x1f, 0x1e, /* q */
+	0x1f, 0x1f, 0x05, 0x05, 0x1f, 0x1a, /* r */
+	0x02, 0x17, 0x15, 0x15, 0x1d, 0x08, /* s */
+	0x01, 0x01, 0x1f, 0x1f, 0x01, 0x01, /* t */
+	0x0f, 0x1f, 0x10, 0x10, 0x1f, 0x0f, /* u */
+	0x07, 0x0f, 0x18, 0x18, 0x0f, 0x07, /* v */
+	0x0f, 0x1f, 0x18, 0x0c, 0x18, 0x1f, 0x0f, /* w */
+	0x11, 0x1b, 0x0e, 0x0e, 0x1b, 0x11, /* x */
+	0x01, 0x03, 0x1e, 0x1e, 0x03, 0x01, /* y */
+	0x11, 0x19, 0x1d, 0x17, 0x13, 0x11, /* z */
+	0x04, 0x04, 0x1f, 0x1b, 0x11, 0x11, /* { */
+	0x3f, 0x3f, /* | */
+	0x11, 0x11, 0x1b, 0x1f, 0x04, 0x04, /* } */
+	0x02, 0x01, 0x03, 0x03, 0x02, 0x01, /* ~ */
+	0x09, 0x1d, 0x14, 0x14, 0x1d, 0x1d, /* Ä */
+	0x09, 0x1d, 0x14, 0x14, 0x1d, 0x09, /* Ö */
+	0x0d, 0x1d, 0x10, 0x10, 0x1d, 0x0d, /* Ü */
+	0x3e, 0x3f, 0x01, 0x15, 0x15, 0x1f, 0x0a, /* ß */
+	0x09, 0x1d, 0x14, 0x14, 0x1d, 0x1d, /* ä */
+	0x09, 0x1d, 0x14, 0x14, 0x1d, 0x09, /* ö */
+	0x0d, 0x1d, 0x10, 0x10, 0x1d, 0x0d, /* ü */
+	0x1f, 0x11, 0x11, 0x11, 0x1f, /* fallback */
+};
+
+const uint8_t _widths[] = {
+	2, /*   */
+	2, /* ! */
+	6, /* " */
+	6, /* # */
+	6, /* $ */
+	6, /* % */
+	7, /* & */
+	2, /* ' */
+	6, /* ( */
+	6, /* ) */
+	7, /* * */
+	6, /* + */
+	2, /* , */
+	6, /* - */
+	2, /* . */
+	6, /* / */
+	6, /* 0 */
+	6, /* 1 */
+	6, /* 2 */
+	6, /* 3 */
+	6, /* 4 */
+	6, /* 5 */
+	6, /* 6 */
+	6, /* 7 */
+	6, /* 8 */
+	6, /* 9 */
+	2, /* : */
+	2, /* ; */
+	6, /* < */
+	6, /* = */
+	6, /* > */
+	6, /* ? */
+	6, /* @ */
+	6, /* A */
+	6, /* B */
+	6, /* C */
+	6, /* D */
+	6, /* E */
+	6, /* F */
+	6, /* G */
+	6, /* H */
+	6, /* I */
+	6, /* J */
+	6, /* K */
+	6, /* L */
+	7, /* M */
+	6, /* N */
+	6, /* O */
+	6, /* P */
+	6, /* Q */
+	6, /* R */
+	6, /* S */
+	6, /* T */
+	6, /* U */
+	6, /* V */
+	7, /* W */
+	6, /* X */
+	6, /* Y */
+	6, /* Z */
+	6, /* [ */
+	6, /* \ */
+	6, /* ] */
+	6, /* ^ */
+	6, /* _ */
+	2, /* ` */
+	6, /* a */
+	6, /* b */
+	6, /* c */
+	6, /* d */
+	6, /* e */
+	6, /* f */
+	6, /* g */
+	6, /* h */
+	6, /* i */
+	6, /* j */
+	6, /* k */
+	6, /* l */
+	7, /* m */
+	6, /* n */
+	6, /* o */
+	6, /* p */
+	6, /* q */
+	6, /* r */
+	6, /* s */
+	6, /* t */
+	6, /* u */
+	6, /* v */
+	7, /* w */
+	6, /* x */
+	6, /* y */
+	6, /* z */
+	6, /* { */
+	2, /* | */
+	6, /* } */
+	6, /* ~ */
+	6, /* Ä */
+	6, /* Ö */
+	6, /* Ü */
+	7, /* ß */
+	6, /* ä */
+	6, /* ö */
+	6, /* ü */
+	5, /* fallback */
+};
 
 const Character characters[] = {
-	Character(8, 6, &_text[0]), /*   */
-	Character(8, 6, &_text[48]), /* ! */
-	Character(8, 6, &_text[96]), /* " */
-	Character(8, 6, &_text[144]), /* # */
-	Character(8, 6, &_text[192]), /* $ */
-	Character(8, 6, &_text[240]), /* % */
-	Character(9, 6, &_text[288]), /* & */
-	Character(8, 6, &_text[342]), /* ' */
-	Character(8, 6, &_text[390]), /* ( */
-	Character(8, 6, &_text[438]), /* ) */
-	Character(9, 6, &_text[486]), /* * */
-	Character(8, 6, &_text[540]), /* + */
-	Character(8, 6, &_text[588]), /* , */
-	Character(8, 6, &_text[636]), /* - */
-	Character(8, 6, &_text[684]), /* . */
-	Character(8, 6, &_text[732]), /* / */
-	Character(8, 6, &_text[780]), /* 0 */
-	Character(8, 6, &_text[828]), /* 1 */
-	Character(8, 6, &_text[876]), /* 2 */
-	Character(8, 6, &_text[924]), /* 3 */
-	Character(8, 6, &_text[972]), /* 4 */
-	Character(8, 6, &_text[1020]), /* 5 */
-	Character(8, 6, &_text[1068]), /* 6 */
-	Character(8, 6, &_text[1116]), /* 7 */
-	Character(8, 6, &_text[1164]), /* 8 */
-	Character(8, 6, &_text[1212]), /* 9 */
-	Character(8, 6, &_text[1260]), /* : */
-	Character(8, 6, &_text[1308]), /* ; */
-	Character(8, 6, &_text[1356]), /* < */
-	Character(8, 6, &_text[1404]), /* = */
-	Character(8, 6, &_text[1452]), /* > */
-	Character(8, 6, &_text[1500]), /* ? */
-	Character(8, 6, &_text[1548]), /* @ */
-	Character(8, 6, &_text[1596]), /* A */
-	Character(8, 6, &_text[1644]), /* B */
-	Character(8, 6, &_text[1692]), /* C */
-	Character(8, 6, &_text[1740]), /* D */
-	Character(8, 6, &_text[1788]), /* E */
-	Character(8, 6, &_text[1836]), /* F */
-	Character(8, 6, &_text[1884]), /* G */
-	Character(8, 6, &_text[1932]), /* H */
-	Character(8, 6, &_text[1980]), /* I */
-	Character(8, 6, &_text[2028]), /* J */
-	Character(8, 6, &_text[2076]), /* K */
-	Character(8, 6, &_text[2124]), /* L */
-	Character(9, 6, &_text[2172]), /* M */
-	Character(8, 6, &_text[2226]), /* N */
-	Character(8, 6, &_text[2274]), /* O */
-	Character(8, 6, &_text[2322]), /* P */
-	Character(8, 6, &_text[2370]), /* Q */
-	Character(8, 6, &_text[2418]), /* R */
-	Character(8, 6, &_text[2466]), /* S */
-	Character(8, 6, &_text[2514]), /* T */
-	Character(8, 6, &_text[2562]), /* U */
-	Character(8, 6, &_text[2610]), /* V */
-	Character(9, 6, &_text[2658]), /* W */
-	Character(8, 6, &_text[2712]), /* X */
-	Character(8, 6, &_text[2760]), /* Y */
-	Character(8, 6, &_text[2808]), /* Z */
-	Character(8, 6, &_text[2856]), /* [ */
-	Character(8, 6, &_text[2904]), /* \ */
-	Character(8, 6, &_text[2952]), /* ] */
-	Character(8, 6, &_text[3000]), /* ^ */
-	Character(8, 6, &_text[3048]), /* _ */
-	Character(8, 6, &_text[3096]), /* ` */
-	Character(8, 6, &_text[3144]), /* a */
-	Character(8, 6, &_text[3192]), /* b */
-	Character(8, 6, &_text[3240]), /* c */
-	Character(8, 6, &_text[3288]), /* d */
-	Character(8, 6, &_text[3336]), /* e */
-	Character(8, 6, &_text[3384]), /* f */
-	Character(8, 6, &_text[3432]), /* g */
-	Character(8, 6, &_text[3480]), /* h */
-	Character(8, 6, &_text[3528]), /* i */
-	Character(8, 6, &_text[3576]), /* j */
-	Character(8, 6, &_text[3624]), /* k */
-	Character(8, 6, &_text[3672]), /* l */
-	Character(9, 6, &_text[3720]), /* m */
-	Character(8, 6, &_text[3774]), /* n */
-	Character(8, 6, &_text[3822]), /* o */
-	Character(8, 6, &_text[3870]), /* p */
-	Character(8, 6, &_text[3918]), /* q */
-	Character(8, 6, &_text[3966]), /* r */
-	Character(8, 6, &_text[4014]), /* s */
-	Character(8, 6, &_text[4062]), /* t */
-	Character(8, 6, &_text[4110]), /* u */
-	Character(8, 6, &_text[4158]), /* v */
-	Character(9, 6, &_text[4206]), /* w */
-	Character(8, 6, &_text[4260]), /* x */
-	Character(8, 6, &_text[4308]), /* y */
-	Character(8, 6, &_text[4356]), /* z */
-	Character(8, 6, &_text[4404]), /* { */
-	Character(8, 6, &_text[4452]), /* | */
+	Character(2, 6, &_columns[0], 0, 6), /*   */
+	Character(2, 6, &_columns[2], 3, 3), /* ! */
+	Character(6, 6, &_columns[4], 1, 1), /* " */
+	Character(6, 6, &_columns[10], 1, 1), /* # */
+	Character(6, 6, &_columns[16], 1, 1), /* $ */
+	Character(6, 6, &_columns[22], 1, 1), /* % */
+	Character(7, 6, &_columns[28], 1, 1), /* & */
+	Character(2, 6, &_columns[35], 3, 3), /* ' */
+	Character(6, 6, &_columns[37], 1, 1), /* ( */
+	Character(6, 6, &_columns[43], 1, 1), /* ) */
+	Character(7, 6, &_columns[49], 1, 1), /* * */
+	Character(6, 6, &_columns[56], 1, 1), /* + */
+	Character(2, 6, &_columns[62], 3, 3), /* , */
+	Character(6, 6, &_columns[64], 1, 1), /* - */
+	Character(2, 6, &_columns[70], 3, 3), /* . */
+	Character(6, 6, &_columns[72], 1, 1), /* / */
+	Character(6, 6, &_columns[78], 1, 1), /* 0 */
+	Character(6, 6, &_columns[84], 1, 1), /* 1 */
+	Character(6, 6, &_columns[90], 1, 1), /* 2 */
+	Character(6, 6, &_columns[96], 1, 1), /* 3 */
+	Character(6, 6, &_columns[102], 1, 1), /* 4 */
+	Character(6, 6, &_columns[108], 1, 1), /* 5 */
+	Character(6, 6, &_columns[114], 1, 1), /* 6 */
+	Character(6, 6, &_columns[120], 1, 1), /* 7 */
+	Character(6, 6, &_columns[126], 1, 1), /* 8 */
+	Character(6, 6, &_columns[132], 1, 1), /* 9 */
+	Character(2, 6, &_columns[138], 3, 3), /* : */
+	Character(2, 6, &_columns[140], 3, 3), /* ; */
+	Character(6, 6, &_columns[142], 1, 1), /* < */
+	Character(6, 6, &_columns[148], 1, 1), /* = */
+	Character(6, 6, &_columns[154], 1, 1), /* > */
+	Character(6, 6, &_columns[160], 1, 1), /* ? */
+	Character(6, 6, &_columns[166], 1, 1), /* @ */
+	Character(6, 6, &_columns[172], 1, 1), /* A */
+	Character(6, 6, &_columns[178], 1, 1), /* B */
+	Character(6, 6, &_columns[184], 1, 1), /* C */
+	Character(6, 6, &_columns[190], 1, 1), /* D */
+	Character(6, 6, &_columns[196], 1, 1), /* E */
+	Character(6, 6, &_columns[202], 1, 1), /* F */
+	Character(6, 6, &_columns[208], 1, 1), /* G */
+	Character(6, 6, &_columns[214], 1, 1), /* H */
+	Character(6, 6, &_columns[220], 1, 1), /* I */
+	Character(6, 6, &_columns[226], 1, 1), /* J */
+	Character(6, 6, &_columns[232], 1, 1), /* K */
+	Character(6, 6, &_columns[238], 1, 1), /* L */
+	Character(7, 6, &_columns[244], 1, 1), /* M */
+	Character(6, 6, &_columns[251], 1, 1), /* N */
+	Character(6, 6, &_columns[257], 1, 1), /* O */
+	Character(6, 6, &_columns[263], 1, 1), /* P */
+	Character(6, 6, &_columns[269], 1, 1), /* Q */
+	Character(6, 6, &_columns[275], 1, 1), /* R */
+	Character(6, 6, &_columns[281], 1, 1), /* S */
+	Character(6, 6, &_columns[287], 1, 1), /* T */
+	Character(6, 6, &_columns[293], 1, 1), /* U */
+	Character(6, 6, &_columns[299], 1, 1), /* V */
+	Character(7, 6, &_columns[305], 1, 1), /* W */
+	Character(6, 6, &_columns[312], 1, 1), /* X */
+	Character(6, 6, &_columns[318], 1, 1), /* Y */
+	Character(6, 6, &_columns[324], 1, 1), /* Z */
+	Character(6, 6, &_columns[330], 1, 1), /* [ */
+	Character(6, 6, &_columns[336], 1, 1), /* \ */
+	Character(6, 6, &_columns[342], 1, 1), /* ] */
+	Character(6, 6, &_columns[348], 1, 1), /* ^ */
+	Character(6, 6, &_columns[354], 1, 1), /* _ */
+	Character(2, 6, &_columns[360], 3, 3), /* ` */
+	Character(6, 6, &_columns[362], 1, 1), /* a */
+	Character(6, 6, &_columns[368], 1, 1), /* b */
+	Character(6, 6, &_columns[374], 1, 1), /* c */
+	Character(6, 6, &_columns[380], 1, 1), /* d */
+	Character(6, 6, &_columns[386], 1, 1), /* e */
+	Character(6, 6, &_columns[392], 1, 1), /* f */
+	Character(6, 6, &_columns[398], 1, 1), /* g */
+	Character(6, 6, &_columns[404], 1, 1), /* h */
+	Character(6, 6, &_columns[410], 1, 1), /* i */
+	Character(6, 6, &_columns[416], 1, 1), /* j */
+	Character(6, 6, &_columns[422], 1, 1), /* k */
+	Character(6, 6, &_columns[428], 1, 1), /* l */
+	Character(7, 6, &_columns[434], 1, 1), /* m */
+	Character(6, 6, &_columns[441], 1, 1), /* n */
+	Character(6, 6, &_columns[447], 1, 1), /* o */
+	Character(6, 6, &_columns[453], 1, 1), /* p */
+	Character(6, 6, &_columns[459], 1, 1), /* q */
+	Character(6, 6, &_columns[465], 1, 1), /* r */
+	Character(6, 6, &_columns[471], 1, 1), /* s */
+	Character(6, 6, &_columns[477], 1, 1), /* t */
+	Character(6, 6, &_columns[483], 1, 1), /* u */
+	Character(6, 6, &_columns[489], 1, 1), /* v */
+	Character(7, 6, &_columns[495], 1, 1), /* w */
+	Character(6, 6, &_columns[502], 1, 1), /* x */
+	Character(6, 6, &_columns[508], 1, 1), /* y */
+	Character(6, 6, &_columns[514], 1, 1), /* z */
+	Character(6, 6, &_columns[520], 1, 1), /* { */
+	Character(2, 6, &_columns[526], 3, 3), /* | */
+	Character(6, 6, &_columns[528], 1, 1), /* } */
+	Character(6, 6, &_columns[534], 1, 1), /* ~ */
+	Character(6, 6, &_columns[540], 1, 1), /* Ä */
+	Character(6, 6, &_columns[546], 1, 1), /* Ö */
+	Character(6, 6, &_columns[552], 1, 1), /* Ü */
+	Character(7, 6, &_columns[558], 1, 1), /* ß */
+	Character(6, 6, &_columns[565], 1, 1), /* ä */
+	Character(6, 6, &_columns[571], 1, 1), /* ö */
+	Character(6, 6, &_columns[577], 1, 1), /* ü */
+	Character(5, 6, &_columns[583], 0, 0), /* fallback */
+};
+
+const uint32_t FIRST_CODEPOINT = 32;
+const unsigned int DIRECT_COUNT = 95;
+
+/* codepoints of the characters following the directly indexed ones, sorted */
+const uint32_t _codepoints[] = {
+	0x00c4, 0x00d6, 0x00dc, 0x00df, 0x00e4, 0x00f6, 0x00fc,
 };
 
+const unsigned int FALLBACK_INDEX = 102;
@@ -0,0 +1,22 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+/**
+ * Stand-in for the parts of the Arduino core used by the drawing code, so it builds on the host (env:native)
+ */
+
+inline unsigned long millis() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>( steady_clock::now().time_since_epoch() ).count();
+}
+
+inline unsigned long micros() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>( steady_clock::now().time_since_epoch() ).count();
+}
+
+inline void delay(unsigned long ms) {
+    std::this_thread::sleep_for( std::chrono::milliseconds( ms ) );
+}
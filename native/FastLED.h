@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <Arduino.h>
+
+/**
+ * Stand-in for the parts of FastLED used by LEDHat, so the drawing code builds on the host (env:native)
+ *
+ * The 8 bit math matches FastLED (scale8, qadd8, blend). The hue conversion is a plain hue circle, so
+ * rainbow colors differ slightly from the ones on the hat. show() only hands the frame to the controllers,
+ * nothing is transmitted.
+ */
+
+typedef uint8_t fract8;
+
+#define DISABLE_DITHER 0x00
+#define BINARY_DITHER 0x01
+
+enum ESPIChipsets { NEOPIXEL };
+
+inline uint8_t scale8(uint8_t i, fract8 scale) {
+    return (uint16_t( i ) * (1 + uint16_t( scale ))) >> 8;
+}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j) {
+    const unsigned int sum = i + j;
+    return sum > 255 ? 255 : sum;
+}
+
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t amountOfB) {
+    uint16_t partial = (uint16_t( a ) << 8) | b;
+    partial += uint16_t( b ) * amountOfB;
+    partial -= uint16_t( a ) * amountOfB;
+    return partial >> 8;
+}
+
+struct CHSV {
+    union {
+        struct {
+            uint8_t h;
+            uint8_t s;
+            uint8_t v;
+        };
+        uint8_t raw[3];
+    };
+
+    CHSV() : h( 0 ), s( 0 ), v( 0 ) {}
+    CHSV(uint8_t h, uint8_t s, uint8_t v) : h( h ), s( s ), v( v ) {}
+};
+
+struct CRGB {
+    union {
+        struct {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+        };
+        uint8_t raw[3];
+    };
+
+    CRGB() : r( 0 ), g( 0 ), b( 0 ) {}
+    constexpr CRGB(uint8_t r, uint8_t g, uint8_t b) : r( r ), g( g ), b( b ) {}
+    CRGB(uint32_t colorcode) : r( (colorcode >> 16) & 0xff ), g( (colorcode >> 8) & 0xff ), b( colorcode & 0xff ) {}
+    CRGB(const CHSV& hsv);
+
+    uint8_t& operator[](uint8_t x) { return raw[x]; }
+    const uint8_t& operator[](uint8_t x) const { return raw[x]; }
+
+    explicit operator bool() const { return r || g || b; }
+};
+
+inline bool operator==(const CRGB& lhs, const CRGB& rhs) {
+    return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b;
+}
+
+inline bool operator!=(const CRGB& lhs, const CRGB& rhs) {
+    return !(lhs == rhs);
+}
+
+/**
+ * Hue circle in 6 sectors (FastLED uses a rainbow with a wider yellow)
+ */
+inline void hsv2rgb_rainbow(const CHSV& hsv, CRGB& rgb) {
+    const uint8_t sector = hsv.h / 43;
+    const uint8_t rise = (hsv.h - sector * 43) * 6;
+    const uint8_t fall = 255 - rise;
+
+    const uint8_t channels[6][3] = {
+        { 255, rise, 0 }, { fall, 255, 0 }, { 0, 255, rise }, { 0, fall, 255 }, { rise, 0, 255 }, { 255, 0, fall },
+    };
+
+    // desaturate towards white, then dim
+    const uint8_t white = 255 - hsv.s;
+    for( int i = 0; i < 3; ++i ) {
+        rgb.raw[i] = scale8( qadd8( scale8( channels[sector][i], hsv.s ), white ), hsv.v );
+    }
+}
+
+inline CRGB::CRGB(const CHSV& hsv) {
+    hsv2rgb_rainbow( hsv, *this );
+}
+
+inline CRGB blend(const CRGB& p1, const CRGB& p2, fract8 amountOfP2) {
+    if( amountOfP2 == 0 ) {
+        return p1;
+    }
+    if( amountOfP2 == 255 ) {
+        return p2;
+    }
+    return CRGB( blend8( p1.r, p2.r, amountOfP2 ), blend8( p1.g, p2.g, amountOfP2 ), blend8( p1.b, p2.b, amountOfP2 ) );
+}
+
+class CLEDController {
+public:
+    CLEDController(CRGB* leds, int count) : _leds( leds ), _count( count ) {}
+
+    CLEDController& setLeds(CRGB* leds, int count) {
+        _leds = leds;
+        _count = count;
+        return *this;
+    }
+
+    CRGB* leds() { return _leds; }
+    int size() const { return _count; }
+
+private:
+    CRGB* _leds;
+    int _count;
+};
+
+class CFastLED {
+public:
+    template <ESPIChipsets CHIPSET, uint8_t DATA_PIN>
+    CLEDController& addLeds(CRGB* leds, int count) {
+        _controllers.push_back( new CLEDController( leds, count ) );
+        return *_controllers.back();
+    }
+
+    void setBrightness(uint8_t brightness) { _brightness = brightness; }
+    void setDither(uint8_t ditherMode) { _ditherMode = ditherMode; }
+    void show() {}
+
+private:
+    std::vector<CLEDController*> _controllers;
+    uint8_t _brightness = 255;
+    uint8_t _ditherMode = BINARY_DITHER;
+};
+
+extern CFastLED FastLED;
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "Benchmark.h"
+#include "LEDHat.h"
+
+#ifndef PIO_UNIT_TESTING // the tests in test/ bring their own main
+
+/**
+ * Scrolls the text through the output path of the hat, so the frames reach the capture selected by
+ * LEDHAT_CAPTURE (file) & LEDHAT_PREVIEW (ANSI terminal preview), see LEDHat::setCapture()
+ */
+static void scroll(const char* text, unsigned long seconds) {
+    auto& hat = LEDHat::Instance();
+    hat.setup();
+    hat.scroll( text, CRGB( 255, 120, 0 ), 24.0f );
+
+    const auto start = millis();
+    while( millis() - start < seconds * 1000 ) {
+        hat.update();
+        delay( 1 );
+    }
+
+    // waits for the last transmission, so its record is complete
+    LEDHat::setCapture( nullptr );
+    printf( "\n%u frames sent, %u dropped\n", hat.sentFrames(), hat.droppedFrames() );
+}
+
+/**
+ * Host entry point of env:native
+ *
+ *     .pio/build/native/program > results.jsonl       prints the benchmark results as JSON lines
+ *     LEDHAT_PREVIEW=1 .pio/build/native/program scroll "Hello World" 5
+ *     LEDHAT_CAPTURE=frames.lhcf .pio/build/native/program scroll
+ */
+int main(int argc, char** argv) {
+    if( argc > 1 && strcmp( argv[1], "scroll" ) == 0 ) {
+        scroll( argc > 2 ? argv[2] : "Hello World", argc > 3 ? strtoul( argv[3], nullptr, 10 ) : 3 );
+        return 0;
+    }
+
+    Benchmark::run( [](const std::string& line) { fputs( line.c_str(), stdout ); } );
+    return 0;
+}
+
+#endif
@@ -0,0 +1,210 @@
+#include <Arduino.h>
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "Benchmark.h"
+#include "LEDHat.h"
+
+namespace Benchmark {
+
+    /**
+     * Runs the operation the given number of times & reports the average duration
+     */
+    template <typename Operation>
+    static void measure(const Reporter& report, const char* benchmark, const char* variant, unsigned int iterations, Operation operation) {
+        const auto start = micros();
+        for( unsigned int i = 0; i < iterations; ++i ) {
+            operation( i );
+        }
+        const auto elapsed = micros() - start;
+
+        std::stringstream line;
+        line << "{\"benchmark\":\"" << benchmark << "\",\"case\":\"" << variant << "\",\"iterations\":" << iterations
+             << ",\"ns_per_op\":" << static_cast<unsigned long long>( elapsed ) * 1000 / iterations << "}\n";
+        report( line.str() );
+    }
+
+    /**
+     * Builds an anti-aliased binary font (LHFN version 2) from the printable ASCII glyphs of the builtin font
+     *
+     * Lit pixels get full coverage, the unlit pixels above & below them half coverage, so the blending
+     * path is measured without a font file on the device.
+     *
+     * @param bits Coverage bits per pixel (2 or 4)
+     * @param font The font
+     * @returns true if the font could be built
+     */
+    static bool antiAliasedFont(unsigned int bits, Font& font) {
+        const uint32_t first = ' ';
+        const uint32_t last = '~';
+        const unsigned int glyphCount = last - first + 2; // + fallback glyph
+
+        Character space;
+        getCharacter( first, space );
+        const auto height = space.height;
+
+        // header: magic, version, height, glyph count, direct count, first codepoint, coverage bits, reserved
+        std::vector<uint8_t> data = { 'L', 'H', 'F', 'N', 2, static_cast<uint8_t>( height ),
+                                      static_cast<uint8_t>( glyphCount ), static_cast<uint8_t>( glyphCount >> 8 ),
+                                      static_cast<uint8_t>( glyphCount - 1 ), static_cast<uint8_t>( (glyphCount - 1) >> 8 ),
+                                      static_cast<uint8_t>( first ), static_cast<uint8_t>( first >> 8 ),
+                                      static_cast<uint8_t>( bits ), 0 };
+
+        // metrics: offset of the first column, width, left & right bearing, reserved
+        std::vector<uint8_t> columns;
+        const uint32_t full = (1u << bits) - 1;
+        for( unsigned int i = 0; i < glyphCount; ++i ) {
+            Character character;
+            getCharacter( i + 1 < glyphCount ? first + i : '?', character );
+
+            const auto offset = columns.size() / bits;
+            data.insert( data.end(), { static_cast<uint8_t>( offset ), static_cast<uint8_t>( offset >> 8 ),
+                                       static_cast<uint8_t>( character.width ), static_cast<uint8_t>( character.leftBearing ),
+                                       static_cast<uint8_t>( character.rightBearing ), 0 } );
+
+            for( unsigned int x = 0; x < character.width; ++x ) {
+                const uint32_t lit = character.columns[x];
+                const uint32_t edge = ((lit << 1) | (lit >> 1)) & ~lit & ((1u << height) - 1);
+
+                uint32_t column = 0;
+                for( unsigned int row = 0; row < height; ++row ) {
+                    const auto level = (lit >> row) & 1 ? full : (edge >> row) & 1 ? full / 2 : 0;
+                    column |= level << (row * bits);
+                }
+                for( unsigned int byte = 0; byte < bits; ++byte ) {
+                    columns.push_back( column >> (8 * byte) );
+                }
+            }
+        }
+
+        data.insert( data.end(), columns.begin(), columns.end() );
+        return Font::load( std::move( data ), font );
+    }
+
+    void run(const Reporter& report) {
+        // not connected to any output, so drawing does not touch the hat
+        std::unique_ptr<LEDHat> hat( new LEDHat( MatrixGeometry::of<HatLayout>() ) );
+        const auto rows = hat->rows();
+        const auto cols = hat->cols();
+        const auto pixels = rows * cols;
+
+        // alternating colors, so no write is skipped as unchanged
+        const CRGB colors[] = { CRGB( 255, 0, 0 ), CRGB( 0, 255, 0 ) };
+        auto color = [&]( unsigned int i ) { return colors[i & 1]; };
+
+        measure( report, "setPixel", "all pixels", 8 * pixels, [&]( unsigned int i ) {
+            hat->setPixel( i % rows, (i / rows) % cols, color( i / pixels ) );
+        } );
+
+        volatile uint8_t sink = 0;
+        measure( report, "getPixel", "all pixels", 8 * pixels, [&]( unsigned int i ) {
+            sink = sink + hat->getPixel( i % rows, (i / rows) % cols ).r;
+        } );
+
+        measure( report, "clear", "full canvas", 200, [&]( unsigned int ) {
+            hat->clear();
+        } );
+
+        Character character;
+        getCharacter( 'W', character );
+
+        struct CharacterCase {
+            const char* name;
+            int row;
+            int col;
+            int maxWrapAround;
+        };
+        const CharacterCase characterCases[] = {
+            { "inside", 0, 10, -1 },
+            { "row offset", 2, 10, -1 },
+            { "clipped left", 0, -2, -1 },
+            { "clipped right", 0, static_cast<int>( cols ) - 2, -1 },
+            { "wrap around", 0, static_cast<int>( cols ) - 2, 5 },
+        };
+        for( const auto& c : characterCases ) {
+            measure( report, "drawCharacter", c.name, 2000, [&]( unsigned int i ) {
+                hat->drawCharacter( character, c.row, c.col, color( i ), c.maxWrapAround );
+            } );
+        }
+
+        struct TextCase {
+            const char* name;
+            int offsetX;
+            int offsetY;
+            bool allowWrapAround;
+        };
+        const TextCase textCases[] = {
+            { "offset 0", 0, 0, true },
+            { "offset 20", 20, 0, true },
+            { "row offset", 0, 2, true },
+            { "clipped left", -20, 0, true },
+            { "clipped right", static_cast<int>( cols ) - 20, 0, false },
+            { "wrap around", static_cast<int>( cols ) - 20, 0, true },
+        };
+        const char* text = "Hello World";
+        for( const auto& c : textCases ) {
+            measure( report, "drawText", c.name, 500, [&]( unsigned int i ) {
+                hat->drawText( text, color( i ), c.offsetX, c.offsetY, c.allowWrapAround );
+            } );
+        }
+        for( const auto& c : textCases ) {
+            measure( report, "drawCachedText", c.name, 500, [&]( unsigned int i ) {
+                hat->drawCachedText( text, color( i ), c.offsetX, c.offsetY, c.allowWrapAround );
+            } );
+        }
+
+        // a full-width ticker message, most of it beyond the right edge
+        const char* longText = "The quick brown fox jumps over the lazy dog 0123456789 ABCDEFGHI";
+        measure( report, "drawText", "64 characters", 200, [&]( unsigned int i ) {
+            hat->drawText( longText, color( i ), 0, 0, false );
+        } );
+        measure( report, "drawCachedText", "64 characters", 200, [&]( unsigned int i ) {
+            hat->drawCachedText( longText, color( i ), 0, 0, false );
+        } );
+
+        // a line of 25 characters, plain & with coverage glyphs that are blended into the canvas
+        const char* line = "Anti-aliased glyphs 12345";
+        Font aa2;
+        Font aa4;
+        const auto antiAliased = antiAliasedFont( 2, aa2 ) && antiAliasedFont( 4, aa4 );
+        const struct {
+            const char* name;
+            const Font& font;
+        } fontCases[] = {
+            { "25 characters 1 bit", Font::builtin() },
+            { "25 characters 2 bit", aa2 },
+            { "25 characters 4 bit", aa4 },
+        };
+        const auto fontCaseCount = antiAliased ? 3 : 1;
+        for( auto c = fontCases; c != fontCases + fontCaseCount; ++c ) {
+            measure( report, "drawText", c->name, 500, [&]( unsigned int i ) {
+                hat->drawText( line, color( i ), 0, 0, false, c->font );
+            } );
+        }
+        for( auto c = fontCases; c != fontCases + fontCaseCount; ++c ) {
+            measure( report, "drawCachedText", c->name, 500, [&]( unsigned int i ) {
+                hat->drawCachedText( line, color( i ), 0, 0, false, c->font );
+            } );
+        }
+
+        struct ColorsCase {
+            const char* name;
+            LEDHat::TextColors colors;
+        };
+        const ColorsCase colorsCases[] = {
+            { "characters", LEDHat::TextColors::characters( { CRGB( 255, 0, 0 ), CRGB( 0, 255, 0 ), CRGB( 0, 0, 255 ) } ) },
+            { "gradient", LEDHat::TextColors::gradient( CRGB( 255, 0, 0 ), CRGB( 0, 0, 255 ) ) },
+            { "gradient canvas", LEDHat::TextColors::gradient( CRGB( 255, 0, 0 ), CRGB( 0, 0, 255 ), LEDHat::TextColors::Span::Canvas ) },
+            { "palette", LEDHat::TextColors::palette( 0, 255 ) },
+            { "rainbow", LEDHat::TextColors::rainbow() },
+        };
+        for( const auto& c : colorsCases ) {
+            measure( report, "drawTextColors", c.name, 500, [&]( unsigned int i ) {
+                // the colors are fixed, so the offset alternates instead
+                hat->drawText( text, c.colors, i & 1, 0, true );
+            } );
+        }
+    }
+}
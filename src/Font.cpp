@@ -0,0 +1,137 @@
+#include "Font.h"
+
+#include <cstring>
+
+/**
+ * Size of the header (version 1 & 2) & of one metrics record of a binary font
+ */
+static const size_t HEADER_SIZE = 12;
+static const size_t HEADER_SIZE_V2 = 14;
+static const size_t METRICS_SIZE = 6;
+
+const Font& Font::builtin() {
+    static Font font = []() {
+        Font font;
+        font._builtin = true;
+
+        Character character;
+        ::getCharacter( ' ', character );
+        font._height = character.height;
+        return font;
+    }();
+    return font;
+}
+
+uint32_t Font::nextId() {
+    static uint32_t id = 0;
+    return ++id;
+}
+
+bool Font::load(std::vector<uint8_t> data, Font& font) {
+    if( data.size() < HEADER_SIZE || memcmp( data.data(), "LHFN", 4 ) != 0 || data[4] < 1 || data[4] > 2 ) {
+        return false;
+    }
+
+    font._data = std::move( data );
+    font._builtin = false;
+    font._id = nextId(); // texts cached with the previous content are invalid
+    font._height = font._data[5];
+    font._glyphCount = font.read( 6, 2 );
+    font._directCount = font.read( 8, 2 );
+    font._firstCodepoint = font.read( 10, 2 );
+
+    // version 2 adds the coverage bits per pixel (anti-aliased glyphs)
+    font._bits = 1;
+    font._metrics = HEADER_SIZE;
+    if( font._data[4] == 2 ) {
+        if( font._data.size() < HEADER_SIZE_V2 ) {
+            return false;
+        }
+        font._bits = font._data[12];
+        font._metrics = HEADER_SIZE_V2;
+    }
+
+    // there is at least the fallback glyph after the direct ones
+    if( font._height == 0 || font._height > 8 || font._directCount >= font._glyphCount ||
+        (font._bits != 1 && font._bits != 2 && font._bits != 4) ) {
+        return false;
+    }
+
+    font._codepoints = font._metrics + font._glyphCount * METRICS_SIZE;
+    font._columns = font._codepoints + (font._glyphCount - font._directCount - 1) * 4;
+    if( font._columns > font._data.size() ) {
+        return false;
+    }
+
+    // every glyph must lie inside the file
+    for( unsigned int i = 0; i < font._glyphCount; ++i ) {
+        const auto metrics = font._metrics + i * METRICS_SIZE;
+        if( font._columns + (font.read( metrics, 2 ) + font._data[metrics + 2]) * font._bits > font._data.size() ) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint32_t Font::read(size_t offset, unsigned int bytes) const {
+    uint32_t value = 0;
+    for( unsigned int i = 0; i < bytes; ++i ) {
+        value |= uint32_t( _data[offset + i] ) << (8 * i);
+    }
+    return value;
+}
+
+int Font::glyphIndex(uint32_t codepoint) const {
+    // fast path for the directly indexed codepoints (ASCII)
+    if( codepoint - _firstCodepoint < _directCount ) {
+        return codepoint - _firstCodepoint;
+    }
+
+    if( codepoint < ' ' ) {
+        return -1;
+    }
+
+    // binary search in the sorted codepoint table
+    unsigned int low = 0;
+    unsigned int high = _glyphCount - _directCount - 1;
+    while( low < high ) {
+        const auto middle = (low + high) / 2;
+        if( read( _codepoints + middle * 4, 4 ) < codepoint ) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if( low < _glyphCount - _directCount - 1 && read( _codepoints + low * 4, 4 ) == codepoint ) {
+        return _directCount + low;
+    }
+
+    return _glyphCount - 1; // fallback
+}
+
+bool Font::getCharacter(uint32_t codepoint, Character& character) const {
+    if( _builtin ) {
+        return ::getCharacter( codepoint, character );
+    }
+
+    const auto index = glyphIndex( codepoint );
+    if( index < 0 ) {
+        return false;
+    }
+
+    const auto metrics = _metrics + index * METRICS_SIZE;
+    character = Character( _data[metrics + 2], _height, _data.data() + _columns + read( metrics, 2 ) * _bits, _data[metrics + 3], _data[metrics + 4],
+                           _bits );
+    return true;
+}
+
+int Font::getCharacterWidth(uint32_t codepoint) const {
+    if( _builtin ) {
+        return ::getCharacterWidth( codepoint );
+    }
+
+    const auto index = glyphIndex( codepoint );
+    return index < 0 ? -1 : _data[_metrics + index * METRICS_SIZE + 2];
+}
@@ -0,0 +1,66 @@
+#include "FrameCapture.h"
+
+FrameCapture::FrameCapture(const char* path, bool preview) : _recording( path != nullptr ), _preview( preview ) {
+    if( path == nullptr ) {
+        return;
+    }
+
+    _file = fopen( path, "wb" );
+    if( _file != nullptr ) {
+        fwrite( "LHCF\x01", 1, 5, _file );
+    }
+}
+
+FrameCapture::~FrameCapture() {
+    if( _file != nullptr ) {
+        fclose( _file );
+    }
+}
+
+void FrameCapture::write(unsigned int output, const MatrixGeometry& geometry, const CRGB* leds, unsigned long timestamp, unsigned long renderMicros) {
+    if( _file != nullptr ) {
+        writeValue( timestamp, 4 );
+        writeValue( renderMicros, 4 );
+        writeValue( output, 1 );
+        writeValue( geometry.rows, 1 );
+        writeValue( geometry.cols, 2 );
+
+        // back from the wiring order into column order
+        for( unsigned int i = 0; i < geometry.numLeds(); ++i ) {
+            const auto& pixel = leds[geometry.ledTable[i]];
+            fwrite( pixel.raw, 1, 3, _file );
+        }
+
+        // complete records even if the recording is interrupted
+        fflush( _file );
+    }
+
+    if( _preview ) {
+        preview( output, geometry, leds );
+    }
+}
+
+void FrameCapture::writeValue(uint32_t value, unsigned int bytes) {
+    for( unsigned int i = 0; i < bytes; ++i ) {
+        fputc( (value >> (8 * i)) & 0xFF, _file );
+    }
+}
+
+void FrameCapture::preview(unsigned int output, const MatrixGeometry& geometry, const CRGB* leds) {
+    // every output gets its own lines below the previous ones
+    while( _previewLines.size() <= output ) {
+        _previewLines.push_back( _previewEnd );
+        _previewEnd += geometry.rows + 1;
+    }
+
+    // move to the lines of this output & draw two characters per pixel
+    printf( "\x1b[%u;1H", _previewLines[output] );
+    for( unsigned int row = 0; row < geometry.rows; ++row ) {
+        for( unsigned int col = 0; col < geometry.cols; ++col ) {
+            const auto& pixel = leds[geometry.ledTable[col * geometry.rows + row]];
+            printf( "\x1b[48;2;%u;%u;%um  ", pixel.r, pixel.g, pixel.b );
+        }
+        printf( "\x1b[0m\n" );
+    }
+    fflush( stdout );
+}
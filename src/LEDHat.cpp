@@ -1,118 +1,1501 @@
 #include "LEDHat.h"
 #include "IO.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef ESP32
+#include <cstdlib>
+#include <thread>
+#endif
+
 LEDHat &LEDHat::Instance()
 {
-    static LEDHat instance;
+    static LEDHat instance(MatrixGeometry::of<HatLayout>());
     return instance;
 }
 
+LEDHat::LEDHat(const MatrixGeometry &geometry)
+    : _geometry(geometry),
+      _canvasWidth(geometry.cols),
+      _dirtyColumns(geometry.cols, true),
+      _composed(geometry.numLeds(), CRGB(0, 0, 0)),
+      _columnSums(geometry.cols, {0, 0, 0})
+{
+    for (auto &buffer : _ledBuffers)
+    {
+        buffer.assign(_geometry.numLeds(), CRGB(0, 0, 0));
+    }
+
+    allocateLayer(_layers[0]);
+}
+
+std::mutex &LEDHat::_outputMutex = *new std::mutex;
+std::condition_variable &LEDHat::_outputCondition = *new std::condition_variable;
+bool LEDHat::_outputBusy = false;
+std::vector<LEDHat *> LEDHat::_outputs;
+FrameCapture *LEDHat::_capture = nullptr;
+
 void LEDHat::setup()
 {
-    FastLED.addLeds<NEOPIXEL, PIN>(_ledBuffer, NUM_LEDS);
+    setup<PIN>();
+}
+
+void LEDHat::attach(CLEDController &controller)
+{
+    _controller = &controller;
+
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    _outputs.push_back(this);
+    if (_outputs.size() > 1)
+    {
+        return; // output task is already running
+    }
+
+    // brightness & dithering are applied by our own output stage
+    FastLED.setBrightness(255);
+    FastLED.setDither(DISABLE_DITHER);
+
+#ifndef ESP32
+    // host builds select the capture by environment
+    const auto *capturePath = getenv("LEDHAT_CAPTURE");
+    const auto preview = getenv("LEDHAT_PREVIEW") != nullptr;
+    if (capturePath != nullptr || preview)
+    {
+        static FrameCapture capture(capturePath, preview);
+        _capture = &capture;
+    }
+#endif
+
+#ifdef ESP32
+    // The arduino loop (and with it lua) runs on core 1, so transmit on core 0
+    xTaskCreatePinnedToCore([](void *) { outputLoop(); }, "LEDHatOutput", 4096, nullptr, 1, nullptr, 0);
+#else
+    std::thread(&LEDHat::outputLoop).detach();
+
+    // the program may end while a frame is transmitted, which still reads the led matrices
+    std::atexit([] {
+        std::unique_lock<std::mutex> lock(_outputMutex);
+        _outputCondition.wait(lock, [] { return !_outputBusy; });
+    });
+#endif
+}
+
+unsigned int LEDHat::canvasIndex(unsigned int row, unsigned int col) const
+{
+    return col * _geometry.rows + row;
+}
+
+void LEDHat::markDirty(unsigned int col)
+{
+    // canvas column -> column on the led matrix
+    auto screenCol = col >= _viewport ? col - _viewport : col + _canvasWidth - _viewport;
+
+    if (screenCol < _geometry.cols)
+    {
+        _dirtyColumns[screenCol] = true;
+        _anyDirty = true;
+    }
+}
+
+void LEDHat::markAllDirty()
+{
+    std::fill(_dirtyColumns.begin(), _dirtyColumns.end(), true);
+    _anyDirty = true;
+}
+
+bool LEDHat::setCanvasWidth(unsigned int width)
+{
+    // clamped to the led matrix & the maximum (a led matrix wider than the maximum keeps its width)
+    const unsigned int maxWidth = MAX_CANVAS_WIDTH;
+    width = std::max(std::min(width, maxWidth), _geometry.cols);
+    if (!fitsCanvas(width, layerCount()))
+    {
+        return false;
+    }
+
+    _canvasWidth = width;
+    for (auto &layer : _layers)
+    {
+        layer.pixels.clear();
+        layer.indices.clear();
+        allocateLayer(layer);
+    }
+    _viewport = 0;
+    markAllDirty();
+    return true;
+}
+
+void LEDHat::setViewport(int offset)
+{
+    // normalize into [0, canvas width)
+    auto viewport = static_cast<unsigned int>((offset % static_cast<int>(_canvasWidth) + _canvasWidth) % _canvasWidth);
+
+    if (viewport != _viewport)
+    {
+        _viewport = viewport;
+        markAllDirty();
+    }
+}
+
+bool LEDHat::setLayerCount(unsigned int count)
+{
+    const unsigned int maxLayers = MAX_LAYERS;
+    count = std::max(std::min(count, maxLayers), 1u);
+    if (!fitsCanvas(_canvasWidth, count))
+    {
+        return false;
+    }
+
+    _layers.resize(count);
+    for (auto &layer : _layers)
+    {
+        allocateLayer(layer);
+    }
+
+    _activeLayer = std::min(_activeLayer, layerCount() - 1);
+    markAllDirty();
+    return true;
+}
+
+void LEDHat::selectLayer(unsigned int layer)
+{
+    _activeLayer = std::min(layer, layerCount() - 1);
+}
+
+void LEDHat::setLayerOpacity(unsigned int layer, uint8_t opacity)
+{
+    if (layer < layerCount() && _layers[layer].opacity != opacity)
+    {
+        _layers[layer].opacity = opacity;
+        markAllDirty();
+    }
 }
 
-void LEDHat::indexToCoordinate(unsigned int idx, unsigned int &row, unsigned int &col)
+void LEDHat::setLayerBlendMode(unsigned int layer, BlendMode mode)
 {
-    col = idx / ROWS;
-    row = idx % ROWS;
+    if (layer < layerCount() && _layers[layer].mode != mode)
+    {
+        _layers[layer].mode = mode;
+        markAllDirty();
+    }
+}
 
-    if (col % 2 == 1)
+void LEDHat::setLayerIndexed(unsigned int layer, bool indexed)
+{
+    if (layer >= layerCount() || _layers[layer].indexed == indexed)
     {
-        row = (ROWS - 1) - row;
+        return;
     }
+
+    auto &l = _layers[layer];
+    l.indexed = indexed;
+
+    // the canvas of the other format is released
+    std::vector<CRGB>().swap(l.pixels);
+    std::vector<uint8_t>().swap(l.indices);
+    allocateLayer(l);
+
+    markAllDirty();
 }
 
-int LEDHat::coordinateToIndex(int row, int col)
+void LEDHat::allocateLayer(Layer &layer)
 {
-    int idx = col * ROWS;
-    if (col % 2 == 0)
+    if (layer.indexed)
     {
-        idx += row;
+        layer.indices.resize(_geometry.rows * _canvasWidth, 0);
     }
     else
     {
-        idx += ((ROWS - 1) - row);
+        layer.pixels.resize(_geometry.rows * _canvasWidth, CRGB(0, 0, 0));
+    }
+}
+
+std::array<CRGB, LEDHat::PALETTE_SIZE> LEDHat::makeDefaultPalette()
+{
+    std::array<CRGB, PALETTE_SIZE> palette;
+    for (unsigned int i = 0; i < PALETTE_SIZE; ++i)
+    {
+        palette[i] = CRGB(i, i, i);
     }
 
-    return idx;
+    return palette;
 }
 
-void LEDHat::clear()
+void LEDHat::setPaletteColor(uint8_t index, CRGB color)
+{
+    _palette[index] = color;
+    paletteChanged();
+}
+
+void LEDHat::rotatePalette(int steps, uint8_t first /*= 0*/, uint8_t last /*= 255*/)
 {
-    for (auto i = 0; i < NUM_LEDS; ++i)
+    if (first >= last)
     {
-        _ledBuffer[i].red = _ledBuffer[i].green = _ledBuffer[i].blue = 0;
+        return;
     }
+
+    const auto length = last - first + 1;
+    steps = (steps % length + length) % length;
+
+    // entry i gets the color of entry i - steps
+    std::rotate(_palette.begin() + first, _palette.begin() + last + 1 - steps, _palette.begin() + last + 1);
+    paletteChanged();
+}
+
+void LEDHat::fillPaletteGradient(uint8_t first, uint8_t last, CRGB from, CRGB to)
+{
+    for (unsigned int i = first; i <= last; ++i)
+    {
+        _palette[i] = first == last ? from : blend(from, to, (i - first) * 255 / (last - first));
+    }
+
+    paletteChanged();
 }
 
-void LEDHat::drawCharacter(const Character &c, int row, int col, CRGB color, int maxWrapAround /*= 0*/)
+void LEDHat::paletteChanged()
 {
-    for (auto x = 0; x < c.width; ++x)
+    _paletteLookupValid = false;
+
+    for (const auto &layer : _layers)
     {
-        for (auto y = 0; y < c.height; ++y)
+        if (layer.indexed)
         {
-            auto fixedCol = (col + x) % COLS; // column after wrap around
+            markAllDirty();
+            return;
+        }
+    }
+}
 
-            // wrap around is performed and maxWrapAround is hit --> return (we do not need to anything more)
-            if (col + x > COLS && fixedCol > maxWrapAround)
-            {
-                return;
-            }
+uint8_t LEDHat::paletteIndexOf(CRGB color)
+{
+    if (_paletteLookupValid && _paletteLookupColor == color)
+    {
+        return _paletteLookupIndex;
+    }
+
+    auto bestDistance = INT32_MAX;
+    for (unsigned int i = 0; i < PALETTE_SIZE && bestDistance != 0; ++i)
+    {
+        const auto &entry = _palette[i];
+        auto distance = abs(entry.r - color.r) + abs(entry.g - color.g) + abs(entry.b - color.b);
+
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            _paletteLookupIndex = i;
+        }
+    }
+
+    _paletteLookupColor = color;
+    _paletteLookupValid = true;
+    return _paletteLookupIndex;
+}
+
+void LEDHat::composeColumn(unsigned int col, CRGB *out) const
+{
+    for (unsigned int row = 0; row < _geometry.rows; ++row)
+    {
+        out[row] = CRGB(0, 0, 0);
+    }
+
+    for (const auto &layer : _layers)
+    {
+        if (layer.opacity == 0)
+        {
+            continue;
+        }
 
-            if (fixedCol < 0)
+        // expand the column of an indexed layer through the palette first
+        CRGB expanded[MAX_ROWS];
+        const CRGB *pixels;
+        if (layer.indexed)
+        {
+            const auto *indices = &layer.indices[canvasIndex(0, col)];
+            for (unsigned int row = 0; row < _geometry.rows; ++row)
             {
-                continue;
+                expanded[row] = _palette[indices[row]];
             }
+            pixels = expanded;
+        }
+        else
+        {
+            pixels = &layer.pixels[canvasIndex(0, col)];
+        }
 
-            auto idx = coordinateToIndex(row + y, fixedCol);
+        for (unsigned int row = 0; row < _geometry.rows; ++row)
+        {
+            const auto &src = pixels[row];
+            auto &dst = out[row];
 
-            if (c.data[y * c.width + x] - '0')
+            switch (layer.mode)
             {
-                _ledBuffer[idx] = color;
+            case BlendMode::Replace:
+                if (src)
+                {
+                    dst = src;
+                }
+                break;
+
+            case BlendMode::Alpha:
+                if (src)
+                {
+                    dst = blend(dst, src, layer.opacity);
+                }
+                break;
+
+            case BlendMode::Add:
+                dst.r = qadd8(dst.r, scale8(src.r, layer.opacity));
+                dst.g = qadd8(dst.g, scale8(src.g, layer.opacity));
+                dst.b = qadd8(dst.b, scale8(src.b, layer.opacity));
+                break;
+
+            case BlendMode::Multiply:
+                dst = blend(dst, CRGB(scale8(dst.r, src.r), scale8(dst.g, src.g), scale8(dst.b, src.b)), layer.opacity);
+                break;
             }
         }
     }
 }
 
-void LEDHat::drawText(const char *text, CRGB color, int offsetX /*= 0*/, int offsetY /*= 0*/, bool allowWrapAround /*= true*/)
+void LEDHat::clear()
+{
+    auto &layer = activeLayer();
+    std::fill(layer.pixels.begin(), layer.pixels.end(), CRGB(0, 0, 0));
+    std::fill(layer.indices.begin(), layer.indices.end(), 0);
+    markAllDirty();
+
+    // the marquee is drawn again even if it did not move
+    _marquee.position = -1;
+}
+
+void LEDHat::drawCharacter(const Character &c, int row, int col, CRGB color, int maxWrapAround /*= -1*/)
+{
+    drawColumns(c.columns, c.bits, c.width, row, col, color, maxWrapAround);
+}
+
+void LEDHat::drawColumns(const uint8_t *columns, unsigned int bits, int width, int row, int col, CRGB color, int maxWrapAround)
+{
+    drawColumns(columns, bits, width, row, col, [&](int, unsigned int) { return color; }, maxWrapAround);
+}
+
+template <typename ColorAt>
+void LEDHat::drawColumns(const uint8_t *columns, unsigned int bits, int width, int row, int col, ColorAt colorAt, int maxWrapAround)
+{
+    // shift of the column masks to reach the target row. Rows outside the matrix are shifted out
+    if (row <= -8 || row >= static_cast<int>(_geometry.rows))
+    {
+        return;
+    }
+
+    const auto rowMask = _geometry.rows >= 32 ? ~uint32_t(0) : (uint32_t(1) << _geometry.rows) - 1;
+    const auto shiftDown = row >= 0 ? row : 0;
+    const auto shiftUp = row < 0 ? -row : 0;
+
+    // plain glyphs are written as bit masks, anti-aliased ones are blended by their coverage
+    const auto drawColumn = [&](int x, unsigned int canvasCol) {
+        if (bits == 1)
+        {
+            writeColumn(canvasCol, (uint32_t(columns[x]) << shiftDown >> shiftUp) & rowMask, colorAt(x, canvasCol));
+        }
+        else
+        {
+            blendColumn(canvasCol, glyphColumn(columns, bits, x), bits, row, colorAt(x, canvasCol));
+        }
+    };
+
+    const auto canvasWidth = static_cast<int>(_canvasWidth);
+
+    // part which lies directly on the canvas (negative columns are never drawn)
+    const auto directStart = std::max(0, -col);
+    const auto directEnd = std::min(width, canvasWidth - col);
+
+    for (auto x = directStart; x < directEnd; ++x)
+    {
+        drawColumn(x, col + x);
+    }
+
+    // part which exceeds the column count and is wrapped around up to maxWrapAround
+    if (maxWrapAround < 0)
+    {
+        return;
+    }
+
+    const auto wrapStart = std::max(0, canvasWidth - col);
+    const auto wrapEnd = std::min(width, std::min(maxWrapAround, canvasWidth - 1) + 1 + canvasWidth - col);
+
+    for (auto x = wrapStart; x < wrapEnd; ++x)
+    {
+        drawColumn(x, col + x - canvasWidth);
+    }
+}
+
+void LEDHat::writeColumn(unsigned int col, uint32_t mask, CRGB color)
+{
+    if (mask == 0)
+    {
+        return;
+    }
+
+    auto &layer = activeLayer();
+    if (layer.indexed)
+    {
+        const auto index = paletteIndexOf(color);
+        auto *indices = &layer.indices[canvasIndex(0, col)];
+        for (; mask != 0; mask &= mask - 1) // visit the set bits only
+        {
+            indices[__builtin_ctz(mask)] = index;
+        }
+    }
+    else
+    {
+        auto *pixels = &layer.pixels[canvasIndex(0, col)];
+        for (; mask != 0; mask &= mask - 1) // visit the set bits only
+        {
+            pixels[__builtin_ctz(mask)] = color;
+        }
+    }
+
+    markDirty(col);
+}
+
+void LEDHat::blendColumn(unsigned int col, uint32_t coverage, unsigned int bits, int row, CRGB color)
 {
-    const auto startPos = offsetX;
+    const auto full = (1u << bits) - 1;
+    const auto scale = 255 / full; // 85 for 2 bits, 17 for 4 bits
+    const auto rows = static_cast<int>(_geometry.rows);
 
-    auto len = strlen(text);
-    for (auto i = 0; i < len; ++i)
+    auto &layer = activeLayer();
+    auto changed = false;
+    while (coverage != 0) // visit the covered pixels only
     {
-        Character c;
-        if (!getCharacter(text[i], c))
+        const auto shift = __builtin_ctz(coverage) / bits * bits;
+        const auto level = (coverage >> shift) & full;
+        coverage &= ~(full << shift);
+
+        const auto y = row + static_cast<int>(shift / bits);
+        if (y < 0 || y >= rows)
         {
             continue;
         }
 
-        if (allowWrapAround)
+        if (layer.indexed)
         {
-            drawCharacter(c, offsetY, offsetX, color, startPos - 1); // Wrap around is allowed until 1 column before start of first character
+            // palette indices can not be mixed, the pixel is set if it is covered at least by half
+            if (level * scale >= 128)
+            {
+                layer.indices[canvasIndex(y, col)] = paletteIndexOf(color);
+            }
         }
         else
         {
-            drawCharacter(c, offsetY, offsetX, color, 0); // No wrap around is allowed
+            auto &pixel = layer.pixels[canvasIndex(y, col)];
+            pixel = level == full ? color : blend(pixel, color, level * scale);
+        }
+        changed = true;
+    }
+
+    if (changed)
+    {
+        markDirty(col);
+    }
+}
+
+void LEDHat::drawText(const char *text, CRGB color, int offsetX /*= 0*/, int offsetY /*= 0*/, bool allowWrapAround /*= true*/,
+                      const Font &font /*= Font::builtin()*/)
+{
+    drawGlyphs(text, offsetX, offsetY, allowWrapAround, font, [color](unsigned int, int, int, unsigned int) { return color; });
+}
+
+template <typename GlyphColor>
+void LEDHat::drawGlyphs(const char *text, int offsetX, int offsetY, bool allowWrapAround, const Font &font, GlyphColor glyphColor)
+{
+    // Wrap around is allowed until 1 column before start of first character
+    const auto maxWrapAround = allowWrapAround ? offsetX - 1 : -1;
+
+    // first column which can not be drawn anymore
+    const auto canvasWidth = static_cast<int>(_canvasWidth);
+    const auto endPos = canvasWidth + std::max(-1, std::min(maxWrapAround, canvasWidth - 1)) + 1;
+
+    // the next codepoint is decoded ahead for the kerning
+    unsigned int index = 0;
+    for (auto codepoint = decodeUtf8(text); codepoint != 0 && offsetX < endPos;)
+    {
+        const auto next = decodeUtf8(text);
+
+        Character c;
+        if (font.getCharacter(codepoint, c))
+        {
+            const auto glyphCol = offsetX + _spacing.offset(c);
+            drawColumns(c.columns, c.bits, c.width, offsetY, glyphCol,
+                        [&](int x, unsigned int canvasCol) { return glyphColor(index, glyphCol, x, canvasCol); }, maxWrapAround);
+
+            offsetX += _spacing.advance(c, codepoint, next);
+            ++index;
+        }
+        codepoint = next;
+    }
+}
+
+LEDHat::TextColors LEDHat::TextColors::characters(std::vector<CRGB> colors)
+{
+    TextColors textColors;
+    textColors.mode = Mode::Characters;
+    textColors.colors = std::move(colors);
+    return textColors;
+}
+
+LEDHat::TextColors LEDHat::TextColors::gradient(CRGB from, CRGB to, Span span /*= Span::Text*/)
+{
+    TextColors textColors;
+    textColors.mode = Mode::Gradient;
+    textColors.span = span;
+    textColors.colors = {from, to};
+    return textColors;
+}
+
+LEDHat::TextColors LEDHat::TextColors::palette(uint8_t first, uint8_t last, Span span /*= Span::Text*/)
+{
+    TextColors textColors;
+    textColors.mode = Mode::Palette;
+    textColors.span = span;
+    textColors.first = first;
+    textColors.last = last;
+    return textColors;
+}
+
+LEDHat::TextColors LEDHat::TextColors::rainbow(uint8_t hueOffset /*= 0*/, Span span /*= Span::Text*/)
+{
+    TextColors textColors;
+    textColors.mode = Mode::Rainbow;
+    textColors.span = span;
+    textColors.hueOffset = hueOffset;
+    return textColors;
+}
+
+void LEDHat::drawText(const char *text, const TextColors &colors, int offsetX /*= 0*/, int offsetY /*= 0*/, bool allowWrapAround /*= true*/,
+                      const Font &font /*= Font::builtin()*/)
+{
+    if (colors.mode != TextColors::Mode::Rainbow && colors.mode != TextColors::Mode::Palette && colors.colors.empty())
+    {
+        return;
+    }
+
+    // color of the given step of the gradient, spread across the text or the canvas
+    const auto canvasWidth = static_cast<int>(_canvasWidth);
+    const auto textStart = offsetX;
+    const auto steps = std::max(1, colors.span == TextColors::Span::Text ? static_cast<int>(measureText(text, font)) : canvasWidth);
+    const auto colorAt = [&](int step) -> CRGB {
+        step = std::min(std::max(step, 0), steps - 1);
+        switch (colors.mode)
+        {
+        case TextColors::Mode::Gradient:
+            return steps <= 1 ? colors.colors[0] : blend(colors.colors[0], colors.colors[colors.colors.size() > 1 ? 1 : 0], step * 255 / (steps - 1));
+
+        case TextColors::Mode::Palette:
+            return _palette[steps <= 1 ? colors.first : colors.first + (colors.last - colors.first) * step / (steps - 1)];
+
+        default: // the hue circle wraps around, so the rainbow covers the whole span
+            return CHSV(colors.hueOffset + step * 256 / steps, 255, 255);
         }
+    };
 
-        offsetX += c.width;
+    if (colors.mode == TextColors::Mode::Characters)
+    {
+        drawGlyphs(text, offsetX, offsetY, allowWrapAround, font,
+                   [&](unsigned int index, int, int, unsigned int) { return colors.colors[index % colors.colors.size()]; });
+    }
+    else if (colors.span == TextColors::Span::Text)
+    {
+        drawGlyphs(text, offsetX, offsetY, allowWrapAround, font,
+                   [&](unsigned int, int glyphCol, int x, unsigned int) { return colorAt(glyphCol + x - textStart); });
+    }
+    else
+    {
+        drawGlyphs(text, offsetX, offsetY, allowWrapAround, font,
+                   [&](unsigned int, int, int, unsigned int canvasCol) { return colorAt(canvasCol); });
     }
 }
 
-void LEDHat::setPixel(int y, int x, CRGB color) {
-   auto idx = coordinateToIndex(y, x);
+void LEDHat::drawCachedText(const char *text, CRGB color, int offsetX /*= 0*/, int offsetY /*= 0*/, bool allowWrapAround /*= true*/,
+                            const Font &font /*= Font::builtin()*/)
+{
+    const auto &strip = _textStrips.get(text, font, _spacing);
+
+    // Wrap around is allowed until 1 column before start of the text
+    drawColumns(strip.columns.data(), strip.bits, strip.columns.size() / strip.bits, offsetY, offsetX, color, allowWrapAround ? offsetX - 1 : -1);
+}
+
+unsigned int LEDHat::measureText(const char *text, const Font &font /*= Font::builtin()*/) const
+{
+    auto width = 0;
+    for (auto codepoint = decodeUtf8(text); codepoint != 0;)
+    {
+        const auto next = decodeUtf8(text);
+
+        Character character;
+        if (_spacing.monospace)
+        {
+            // the cells need the bearings
+            if (font.getCharacter(codepoint, character))
+            {
+                width += _spacing.advance(character, codepoint, next);
+            }
+        }
+        else
+        {
+            const auto characterWidth = font.getCharacterWidth(codepoint);
+            if (characterWidth >= 0)
+            {
+                character.width = characterWidth;
+                width += _spacing.advance(character, codepoint, next);
+            }
+        }
+        codepoint = next;
+    }
+
+    return std::max(0, width);
+}
 
-   _ledBuffer[idx] = color; 
+void LEDHat::setTracking(int tracking)
+{
+    _spacing.tracking = tracking;
+    _textStrips.clear();
 }
 
-CRGB LEDHat::getPixel(int y, int x ) {
-   auto idx = coordinateToIndex(y, x);
+void LEDHat::setKerning(uint32_t left, uint32_t right, int adjustment)
+{
+    _spacing.setKerning(left, right, adjustment);
+    _textStrips.clear();
+}
 
-   return _ledBuffer[idx];
+void LEDHat::setMonospace(bool monospace)
+{
+    _spacing.monospace = monospace;
+    _textStrips.clear();
 }
 
-void LEDHat::show() {
-    FastLED.show();
+void LEDHat::drawAlignedText(const char *text, CRGB color, int left, int width, TextAlign align /*= TextAlign::Left*/,
+                             TextOverflow overflow /*= TextOverflow::Clip*/, int offsetY /*= 0*/, const Font &font /*= Font::builtin()*/)
+{
+    std::string shown = text;
+    if (overflow == TextOverflow::Ellipsis && static_cast<int>(measureText(text, font)) > width)
+    {
+        // drop characters from the end until the rest fits together with the ellipsis
+        shown += "...";
+        for (auto length = shown.size() - 3; length > 0 && static_cast<int>(measureText(shown.c_str(), font)) > width;)
+        {
+            // start of the last UTF-8 sequence
+            auto start = length - 1;
+            while (start > 0 && (shown[start] & 0xC0) == 0x80)
+            {
+                --start;
+            }
+            shown.erase(start, length - start);
+            length = start;
+        }
+    }
+
+    const auto textWidth = static_cast<int>(measureText(shown.c_str(), font));
+    auto col = left;
+    if (align == TextAlign::Center)
+    {
+        col += (width - textWidth) / 2;
+    }
+    else if (align == TextAlign::Right)
+    {
+        col += width - textWidth;
+    }
+
+    // only the columns inside the box are drawn
+    const auto right = left + width;
+    const auto *it = shown.c_str();
+    for (auto codepoint = decodeUtf8(it); codepoint != 0 && col < right;)
+    {
+        const auto next = decodeUtf8(it);
+
+        Character character;
+        if (font.getCharacter(codepoint, character))
+        {
+            const auto glyphCol = col + _spacing.offset(character);
+            const auto skip = std::max(0, left - glyphCol);
+            const auto count = std::min(static_cast<int>(character.width), right - glyphCol) - skip;
+            if (count > 0)
+            {
+                drawColumns(character.columns + skip * character.bits, character.bits, count, offsetY, glyphCol + skip, color, -1);
+            }
+            col += _spacing.advance(character, codepoint, next);
+        }
+        codepoint = next;
+    }
+}
+
+void LEDHat::scroll(const char *text, CRGB color, float speed, int offsetY /*= 0*/, const Font &font /*= Font::builtin()*/)
+{
+    _marquee.active = true;
+    _marquee.text = text;
+    _marquee.color = color;
+    _marquee.speed = static_cast<int32_t>(speed * 256);
+    _marquee.offsetY = offsetY;
+    _marquee.font = font;
+    _marquee.layer = _activeLayer;
+    _marquee.start = millis();
+    _marquee.position = -1;
+}
+
+void LEDHat::stopScroll()
+{
+    _marquee.active = false;
+}
+
+void LEDHat::update()
+{
+    // while the output task is busy the frame could not be shown, so the marquee is not even drawn
+    if (!_marquee.active || isOutputBusy())
+    {
+        return;
+    }
+
+    const auto &strip = _textStrips.get(_marquee.text.c_str(), _marquee.font, _spacing);
+
+    // one cycle runs from the text entering on the right until it left on the left
+    const auto cycle = static_cast<int64_t>(cols() + strip.columns.size() / strip.bits) * 256;
+    const auto scrolled = static_cast<int64_t>(_marquee.speed) * static_cast<int64_t>(millis() - _marquee.start) / 1000;
+    const auto position = (scrolled % cycle + cycle) % cycle;
+    if (position == _marquee.position)
+    {
+        return;
+    }
+
+    renderMarquee(strip, position);
+
+    // a dropped frame is rendered & offered again on the next call
+    if (showAsync())
+    {
+        _marquee.position = position;
+    }
+}
+
+void LEDHat::renderMarquee(const TextStrip &strip, int64_t position)
+{
+    if (_marquee.layer >= _layers.size())
+    {
+        return;
+    }
+    auto &layer = _layers[_marquee.layer];
+
+    const auto bits = strip.bits;
+    const auto full = (1u << bits) - 1;
+    const auto scale = 255 / full;
+    const auto width = static_cast<int>(strip.columns.size() / bits);
+    const auto matrixCols = static_cast<int>(cols());
+
+    // position of the first text column in 1/256 columns, offset by the text width to stay positive
+    const auto left = static_cast<int64_t>(matrixCols + width) * 256 - position;
+    const auto col = static_cast<int>(left / 256) - width;
+    const auto fraction = static_cast<unsigned int>(left % 256);
+
+    const auto coverage = [&](int x) -> uint32_t { return x >= 0 && x < width ? glyphColumn(strip.columns.data(), bits, x) : 0; };
+
+    const auto top = std::max(0, _marquee.offsetY);
+    const auto bottom = std::min(static_cast<int>(rows()), _marquee.offsetY + static_cast<int>(_marquee.font.height()));
+
+    for (auto x = 0; x < matrixCols; ++x)
+    {
+        // the text column on the column & the one before it, which is moved in by the fraction
+        const auto current = coverage(x - col);
+        const auto previous = coverage(x - col - 1);
+
+        const auto canvasCol = (_viewport + x) % _canvasWidth;
+        for (auto y = top; y < bottom; ++y)
+        {
+            const auto shift = (y - _marquee.offsetY) * bits;
+            const auto alpha = (((current >> shift) & full) * (256 - fraction) + ((previous >> shift) & full) * fraction) * scale >> 8;
+
+            if (layer.indexed)
+            {
+                layer.indices[canvasIndex(y, canvasCol)] = alpha >= 128 ? paletteIndexOf(_marquee.color) : 0;
+            }
+            else
+            {
+                const auto &color = _marquee.color;
+                layer.pixels[canvasIndex(y, canvasCol)] = CRGB(scale8(color.r, alpha), scale8(color.g, alpha), scale8(color.b, alpha));
+            }
+        }
+        markDirty(canvasCol);
+    }
+}
+
+void LEDHat::drawSprite(const Sprite &sprite, int offsetX, int offsetY, unsigned int frame /*= 0*/, bool allowWrapAround /*= true*/)
+{
+    if (frame >= sprite.frameCount())
+    {
+        return;
+    }
+
+    const auto canvasWidth = static_cast<int>(_canvasWidth);
+    const auto height = static_cast<int>(sprite.height);
+    const auto *run = &sprite.runs[sprite.frames[frame]];
+
+    // position inside the sprite
+    auto col = 0;
+    auto row = 0;
+    while (col < static_cast<int>(sprite.width))
+    {
+        auto length = static_cast<int>(run[0]);
+        const auto index = run[1];
+        run += 2;
+
+        // a run can continue over several columns
+        while (length > 0)
+        {
+            const auto count = std::min(length, height - row);
+            if (index != Sprite::TRANSPARENT)
+            {
+                auto x = offsetX + col;
+                if (allowWrapAround)
+                {
+                    x = (x % canvasWidth + canvasWidth) % canvasWidth;
+                }
+
+                if (x >= 0 && x < canvasWidth)
+                {
+                    writeColumn(x, rowSpan(offsetY + row, offsetY + row + count - 1), sprite.palette[index - 1]);
+                }
+            }
+
+            length -= count;
+            row += count;
+            if (row == height)
+            {
+                row = 0;
+                ++col;
+            }
+        }
+    }
+}
+
+void LEDHat::setPixel(int y, int x, CRGB color)
+{
+    if (y < 0 || y >= static_cast<int>(_geometry.rows) || x < 0 || x >= static_cast<int>(_canvasWidth))
+    {
+        return;
+    }
+
+    auto &layer = activeLayer();
+    if (layer.indexed)
+    {
+        setPixelIndex(y, x, paletteIndexOf(color));
+        return;
+    }
+
+    auto &pixel = layer.pixels[canvasIndex(y, x)];
+    if (pixel != color)
+    {
+        pixel = color;
+        markDirty(x);
+    }
+}
+
+void LEDHat::setPixelIndex(int y, int x, uint8_t index)
+{
+    if (y < 0 || y >= static_cast<int>(_geometry.rows) || x < 0 || x >= static_cast<int>(_canvasWidth))
+    {
+        return;
+    }
+
+    auto &layer = activeLayer();
+    if (!layer.indexed)
+    {
+        setPixel(y, x, _palette[index]);
+        return;
+    }
+
+    auto &pixel = layer.indices[canvasIndex(y, x)];
+    if (pixel != index)
+    {
+        pixel = index;
+        markDirty(x);
+    }
+}
+
+CRGB LEDHat::getPixel(int y, int x)
+{
+    if (y < 0 || y >= static_cast<int>(_geometry.rows) || x < 0 || x >= static_cast<int>(_canvasWidth))
+    {
+        return CRGB(0, 0, 0);
+    }
+
+    const auto &layer = activeLayer();
+    return layer.indexed ? _palette[layer.indices[canvasIndex(y, x)]] : layer.pixels[canvasIndex(y, x)];
+}
+
+uint32_t LEDHat::rowSpan(int top, int bottom) const
+{
+    top = std::max(top, 0);
+    bottom = std::min(bottom, static_cast<int>(_geometry.rows) - 1);
+    if (top > bottom)
+    {
+        return 0;
+    }
+
+    return (~uint32_t(0) >> (31 - (bottom - top))) << top;
+}
+
+void LEDHat::fillRect(int row, int col, int height, int width, CRGB color)
+{
+    const auto mask = rowSpan(row, row + height - 1);
+    if (mask == 0)
+    {
+        return;
+    }
+
+    // one mask write per column, no per pixel index math
+    const auto first = std::max(0, col);
+    const auto last = std::min(col + width, static_cast<int>(_canvasWidth));
+    for (auto x = first; x < last; ++x)
+    {
+        writeColumn(x, mask, color);
+    }
+}
+
+bool LEDHat::fitsCanvas(unsigned int width, unsigned int layers) const
+{
+    const unsigned long maxPixels = MAX_CANVAS_PIXELS;
+    const auto pixels = static_cast<unsigned long>(width) * layers * _geometry.rows;
+    return pixels <= std::max(maxPixels, static_cast<unsigned long>(_geometry.numLeds()));
+}
+
+bool LEDHat::isInRange(int value)
+{
+    return value >= -MAX_COORDINATE && value <= MAX_COORDINATE;
+}
+
+void LEDHat::drawLine(int row0, int col0, int row1, int col1, CRGB color)
+{
+    if (!isInRange(row0) || !isInRange(col0) || !isInRange(row1) || !isInRange(col1))
+    {
+        return;
+    }
+
+    const auto canvasWidth = static_cast<int>(_canvasWidth);
+    const auto rows = static_cast<int>(_geometry.rows);
+    const auto deltaCol = std::abs(col1 - col0);
+    const auto deltaRow = std::abs(row1 - row0);
+    const auto stepCol = col0 < col1 ? 1 : -1;
+    const auto stepRow = row0 < row1 ? 1 : -1;
+
+    // the minor coordinate of a step is the major one scaled by the slope & rounded (half up)
+    auto minor = [](int step, int deltaMajor, int deltaMinor) {
+        return static_cast<int>((2 * int64_t(step) * deltaMinor + deltaMajor) / (2 * int64_t(deltaMajor)));
+    };
+
+    // steps along an axis from start (step direction) which lie inside 0 .. size - 1
+    auto visibleSteps = [](int start, int direction, int delta, int size, int &first, int &last) {
+        first = std::max(0, direction > 0 ? -start : start - (size - 1));
+        last = std::min(delta, direction > 0 ? size - 1 - start : start);
+    };
+
+    int first, last;
+    if (deltaCol >= deltaRow)
+    {
+        // one pixel per column
+        visibleSteps(col0, stepCol, deltaCol, canvasWidth, first, last);
+        for (auto step = first; step <= last; ++step)
+        {
+            const auto row = row0 + stepRow * (deltaCol == 0 ? 0 : minor(step, deltaCol, deltaRow));
+            writeColumn(col0 + stepCol * step, rowSpan(row, row), color);
+        }
+        return;
+    }
+
+    // one pixel per row, the pixels are collected per column, so every column is written once
+    visibleSteps(row0, stepRow, deltaRow, rows, first, last);
+    auto col = -1;
+    uint32_t mask = 0;
+    for (auto step = first; step <= last; ++step)
+    {
+        const auto x = col0 + stepCol * minor(step, deltaRow, deltaCol);
+        if (x != col)
+        {
+            if (mask != 0)
+            {
+                writeColumn(col, mask, color);
+            }
+            col = x;
+            mask = 0;
+        }
+        if (x >= 0 && x < canvasWidth)
+        {
+            mask |= rowSpan(row0 + stepRow * step, row0 + stepRow * step);
+        }
+    }
+
+    if (mask != 0)
+    {
+        writeColumn(col, mask, color);
+    }
+}
+
+void LEDHat::drawCircle(int row, int col, int radius, CRGB color, bool filled /*= false*/)
+{
+    if (radius < 0 || radius > MAX_COORDINATE || !isInRange(row) || !isInRange(col))
+    {
+        return;
+    }
+
+    // only the columns on the canvas get a mask, index 0 = column first
+    const auto canvasWidth = static_cast<int>(_canvasWidth);
+    const auto first = std::max(0, col - radius);
+    const auto last = std::min(canvasWidth - 1, col + radius);
+    if (first > last || row + radius < 0 || row - radius >= static_cast<int>(_geometry.rows))
+    {
+        return;
+    }
+
+    std::vector<uint32_t> masks(last - first + 1, 0);
+    auto plot = [&](int offset, int top, int bottom) {
+        const auto x = col + offset;
+        if (x >= first && x <= last)
+        {
+            masks[x - first] |= filled ? rowSpan(top, bottom) : rowSpan(top, top) | rowSpan(bottom, bottom);
+        }
+    };
+
+    // midpoint algorithm, every step covers the 8 symmetric octants
+    auto x = 0;
+    auto y = radius;
+    auto decision = 1 - radius;
+    while (x <= y)
+    {
+        plot(x, row - y, row + y);
+        plot(-x, row - y, row + y);
+        plot(y, row - x, row + x);
+        plot(-y, row - x, row + x);
+
+        if (decision < 0)
+        {
+            decision += 2 * x + 3;
+        }
+        else
+        {
+            decision += 2 * (x - y) + 5;
+            --y;
+        }
+        ++x;
+    }
+
+    for (auto x = first; x <= last; ++x)
+    {
+        writeColumn(x, masks[x - first], color);
+    }
+}
+
+void LEDHat::fillGradient(int row, int col, int height, int width, CRGB from, CRGB to, bool vertical /*= false*/)
+{
+    if (height <= 0 || width <= 0)
+    {
+        return;
+    }
+
+    const auto steps = (vertical ? height : width) - 1;
+    auto colorAt = [&](int step) { return steps == 0 ? from : blend(from, to, step * 255 / steps); };
+
+    if (!vertical)
+    {
+        // every column has one color
+        const auto mask = rowSpan(row, row + height - 1);
+        if (mask == 0)
+        {
+            return;
+        }
+
+        const auto first = std::max(0, col);
+        const auto last = std::min(col + width, static_cast<int>(_canvasWidth));
+        for (auto x = first; x < last; ++x)
+        {
+            writeColumn(x, mask, colorAt(x - col));
+        }
+        return;
+    }
+
+    // every row has one color, the same one in every column
+    const auto first = std::max(0, row);
+    const auto last = std::min(row + height, static_cast<int>(_geometry.rows));
+    for (auto y = first; y < last; ++y)
+    {
+        fillRect(y, col, 1, width, colorAt(y - row));
+    }
+}
+
+void LEDHat::fillRadialGradient(int row, int col, int radius, CRGB inner, CRGB outer)
+{
+    if (radius > MAX_COORDINATE || !isInRange(row) || !isInRange(col))
+    {
+        return;
+    }
+
+    if (radius <= 0)
+    {
+        setPixel(row, col, inner);
+        return;
+    }
+
+    // only the offsets on the canvas are visited
+    const auto firstX = std::max(-radius, -col);
+    const auto lastX = std::min(radius, static_cast<int>(_canvasWidth) - 1 - col);
+    const auto firstY = std::max(-radius, -row);
+    const auto lastY = std::min(radius, static_cast<int>(_geometry.rows) - 1 - row);
+
+    // same outline as drawCircle(filled) within rounding
+    const auto limit = radius * radius + radius;
+    for (auto dx = firstX; dx <= lastX; ++dx)
+    {
+        for (auto dy = firstY; dy <= lastY; ++dy)
+        {
+            const auto distance2 = dx * dx + dy * dy;
+            if (distance2 > limit)
+            {
+                continue;
+            }
+
+            const auto amount = std::min(255, static_cast<int>(sqrtf(distance2) * 255 / radius));
+            setPixel(row + dy, col + dx, blend(inner, outer, amount));
+        }
+    }
+}
+
+void LEDHat::show()
+{
+    submitFrame(true);
+}
+
+bool LEDHat::showAsync()
+{
+    return submitFrame(false);
+}
+
+bool LEDHat::submitFrame(bool wait)
+{
+    // a frame rendered while the output task is busy would only be dropped, the changes stay dirty instead
+    if (!wait && isOutputBusy())
+    {
+        ++_droppedFrames;
+        return false;
+    }
+
+    auto *frame = renderFrame();
+    if (frame == nullptr)
+    {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(_outputMutex);
+    if (_outputBusy)
+    {
+        if (!wait)
+        {
+            _outputPending = true; // the changes go out with the next frame
+            ++_droppedFrames;
+            return false;
+        }
+
+        _outputCondition.wait(lock, [] { return !_outputBusy; });
+    }
+
+    queueFrame(frame);
+    _outputBusy = true;
+
+    lock.unlock();
+    _outputCondition.notify_all();
+    return true;
+}
+
+bool LEDHat::isOutputBusy()
+{
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    return _outputBusy;
+}
+
+void LEDHat::showAll()
+{
+    std::vector<std::pair<LEDHat *, CRGB *>> frames;
+    for (auto *hat : outputs())
+    {
+        if (auto *frame = hat->renderFrame())
+        {
+            frames.emplace_back(hat, frame);
+        }
+    }
+
+    if (frames.empty())
+    {
+        return;
+    }
+
+    // all frames go out with one transmission, which drives the outputs in parallel
+    std::unique_lock<std::mutex> lock(_outputMutex);
+    _outputCondition.wait(lock, [] { return !_outputBusy; });
+
+    for (auto &hatFrame : frames)
+    {
+        hatFrame.first->queueFrame(hatFrame.second);
+    }
+    _outputBusy = true;
+
+    lock.unlock();
+    _outputCondition.notify_all();
+}
+
+std::vector<LEDHat *> LEDHat::outputs()
+{
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    return _outputs;
+}
+
+void LEDHat::setCapture(FrameCapture *capture)
+{
+    // the output task records while it is busy
+    std::unique_lock<std::mutex> lock(_outputMutex);
+    _outputCondition.wait(lock, [] { return !_outputBusy; });
+    _capture = capture;
+}
+
+CRGB *LEDHat::renderFrame()
+{
+    const auto start = micros();
+    const auto brightness = currentBrightness();
+
+    // Nothing changed, the brightness is stable and there is no dithered pixel needing further frames
+    if (!_anyDirty && !_outputPending && brightness == _outputBrightness && !_ditherPending)
+    {
+        ++_skippedFrames;
+        return nullptr;
+    }
+
+    // Only dirty columns are composed from the layers, the others are still up to date
+    for (unsigned int col = 0; col < _geometry.cols; ++col)
+    {
+        if (_dirtyColumns[col])
+        {
+            composeColumn((_viewport + col) % _canvasWidth, &_composed[col * _geometry.rows]);
+            updateColumnPower(col);
+        }
+    }
+    std::fill(_dirtyColumns.begin(), _dirtyColumns.end(), false);
+    _anyDirty = false;
+
+    auto *frame = _ledBuffers[_backBuffer].data();
+    const auto *lastFrame = _ledBuffers[_backBuffer ^ 1].data();
+    renderOutput(frame, limitBrightness(brightness));
+    _outputBrightness = brightness;
+
+    // Pixels were touched but the frame ends up identical to the last one (e.g. clear & redraw of the same text).
+    // Until the first frame went out the leds may still show anything (they keep their colors through a reset)
+    if (_lastFrameSent && memcmp(frame, lastFrame, _geometry.numLeds() * sizeof(CRGB)) == 0)
+    {
+        _outputPending = false;
+        ++_skippedFrames;
+        return nullptr;
+    }
+
+    _renderMicros = micros() - start;
+    return frame;
+}
+
+void LEDHat::queueFrame(CRGB *frame)
+{
+    _outputFrame = frame;
+    _outputRenderMicros = _renderMicros;
+    _backBuffer ^= 1;
+    _outputPending = false;
+    _lastFrameSent = true;
+    ++_sentFrames;
+}
+
+void LEDHat::updateColumnPower(unsigned int col)
+{
+    const auto *pixels = &_composed[col * _geometry.rows];
+
+    for (unsigned int channel = 0; channel < 3; ++channel)
+    {
+        // output values after gamma at full brightness
+        uint16_t sum = 0;
+        for (unsigned int row = 0; row < _geometry.rows; ++row)
+        {
+            sum += _gamma[channel][pixels[row][channel]] >> 8;
+        }
+
+        _channelSums[channel] += sum - _columnSums[col][channel];
+        _columnSums[col][channel] = sum;
+    }
+}
+
+uint8_t LEDHat::limitBrightness(uint8_t brightness)
+{
+    const uint32_t idle = _geometry.numLeds() * IDLE_MILLIAMPS;
+
+    // current of the color channels at full brightness
+    const uint32_t full = (_channelSums[0] * RED_MILLIAMPS + _channelSums[1] * GREEN_MILLIAMPS + _channelSums[2] * BLUE_MILLIAMPS) / 255;
+
+    auto limited = brightness;
+    if (_powerBudget != 0 && full != 0 && idle + full * brightness / 255 > _powerBudget)
+    {
+        const auto available = _powerBudget > idle ? _powerBudget - idle : 0;
+        limited = std::min<uint32_t>(brightness, available * 255 / full);
+    }
+
+    _powerScale = brightness == 0 ? 255 : limited * 255 / brightness;
+    _estimatedCurrent = idle + full * limited / 255;
+    return limited;
+}
+
+void LEDHat::renderOutput(CRGB *frame, uint8_t brightness)
+{
+    // 0 - 255 -> 0 - 256 so full brightness keeps the values unchanged
+    const uint32_t scale = brightness + (brightness >> 7);
+
+    // The dither threshold changes every frame (bit reversed counter -> evenly spread over time) and is
+    // offset per pixel, so the pixels do not flicker in sync
+    const uint8_t ditherBase = reverseBits(_ditherFrame++);
+
+    // The led table is laid out column-major like the composed buffer, so it maps composed index -> led index
+    const auto *physicalIndex = _geometry.ledTable;
+
+    auto fractions = false;
+    for (unsigned int i = 0; i < _geometry.numLeds(); ++i)
+    {
+        const auto &in = _composed[i];
+        auto &out = frame[physicalIndex[i]];
+        const uint8_t threshold = ditherBase + i * 97;
+
+        for (unsigned int channel = 0; channel < 3; ++channel)
+        {
+            // 8.8 fixed point after gamma & brightness
+            const auto value = (_gamma[channel][in[channel]] * scale) >> 8;
+            const uint8_t fraction = value & 0xFF;
+            auto whole = value >> 8;
+
+            fractions = fractions || fraction != 0;
+            if (_dithering && fraction > threshold && whole < 255)
+            {
+                ++whole; // rounds up with a probability of fraction / 256 over time
+            }
+
+            out[channel] = whole;
+        }
+    }
+
+    _ditherPending = _dithering && fractions;
+}
+
+uint8_t LEDHat::reverseBits(uint8_t value)
+{
+    value = (value & 0xF0) >> 4 | (value & 0x0F) << 4;
+    value = (value & 0xCC) >> 2 | (value & 0x33) << 2;
+    value = (value & 0xAA) >> 1 | (value & 0x55) << 1;
+    return value;
+}
+
+std::array<std::array<uint16_t, 256>, 3> LEDHat::makeGammaTables(float red, float green, float blue)
+{
+    std::array<std::array<uint16_t, 256>, 3> tables;
+    const float gammas[] = {red, green, blue};
+
+    for (unsigned int channel = 0; channel < 3; ++channel)
+    {
+        for (unsigned int i = 0; i < 256; ++i)
+        {
+            tables[channel][i] = lroundf(powf(i / 255.0f, gammas[channel]) * 255.0f * 256.0f);
+        }
+    }
+
+    return tables;
+}
+
+void LEDHat::setGamma(float red, float green, float blue)
+{
+    _gamma = makeGammaTables(red, green, blue);
+    markAllDirty(); // recomposing also updates the power estimate with the new gamma
+}
+
+void LEDHat::setPowerBudget(unsigned int milliamps)
+{
+    _powerBudget = milliamps;
+    _outputPending = true; // the output has to be rendered with the new limit
+}
+
+void LEDHat::setBrightness(uint8_t brightness)
+{
+    fadeBrightness(brightness, 0);
+}
+
+void LEDHat::fadeBrightness(uint8_t brightness, unsigned long duration)
+{
+    _fadeFrom = currentBrightness();
+    _fadeTo = brightness;
+    _fadeStart = millis();
+    _fadeDuration = duration;
+}
+
+uint8_t LEDHat::currentBrightness() const
+{
+    const auto elapsed = millis() - _fadeStart;
+    if (elapsed >= _fadeDuration)
+    {
+        return _fadeTo;
+    }
+
+    return _fadeFrom + (static_cast<int>(_fadeTo) - _fadeFrom) * static_cast<long>(elapsed) / static_cast<long>(_fadeDuration);
+}
+
+void LEDHat::setDithering(bool enabled)
+{
+    _dithering = enabled;
+}
+
+void LEDHat::outputLoop()
+{
+    // outputs which got a new frame with the current transmission (index, led matrix)
+    std::vector<std::pair<unsigned int, LEDHat *>> shown;
+
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(_outputMutex);
+        _outputCondition.wait(lock, [] { return _outputBusy; });
+
+        // point the controllers with a new frame to it, the others repeat their last frame
+        shown.clear();
+        for (unsigned int i = 0; i < _outputs.size(); ++i)
+        {
+            auto *hat = _outputs[i];
+            if (hat->_outputFrame != nullptr)
+            {
+                hat->_controller->setLeds(hat->_outputFrame, hat->_geometry.numLeds());
+                hat->_outputFrame = nullptr;
+                shown.emplace_back(i, hat);
+            }
+        }
+        lock.unlock();
+
+        FastLED.show(); // drives all outputs in parallel
+
+        // the frames stay untouched until the output task is idle again
+        if (_capture != nullptr)
+        {
+            // stamped after the transmission, so the capture shows the frame rate on the hat
+            const auto shownMillis = millis();
+            for (const auto &output : shown)
+            {
+                const auto *hat = output.second;
+                _capture->write(output.first, hat->_geometry, hat->_controller->leds(), shownMillis, hat->_outputRenderMicros);
+            }
+        }
+
+        lock.lock();
+        _outputBusy = false;
+        lock.unlock();
+        _outputCondition.notify_all();
+    }
 }
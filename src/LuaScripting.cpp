@@ -1,5 +1,7 @@
 #include <sstream>
 
+#include <SPIFFS.h>
+
 #include "IO.h"
 #include "LEDHat.h"
 #include "LuaScripting.h"
@@ -30,6 +32,11 @@ namespace LuaScripting {
     /* Proxy functions calls from lua to the LEDHat */
     namespace LEDHatProxy {
 
+        /**
+         * Led matrix the proxy functions are drawing on, see selectOutput
+         */
+        static LEDHat* output = &LEDHat::Instance();
+
         static void stack_dump(lua_State* L, const char* stackname) {
             int i;
             int top = lua_gettop(L);
@@ -77,6 +84,11 @@ namespace LuaScripting {
             printf("--------------- %s STACK ---------------\n", stackname);
         }
 
+        /**
+         * Name of the metatable of font userdata
+         */
+        static const char* const FONT_METATABLE = "LEDHat.Font";
+
         namespace Helpers {
             CRGB lua_tocolor(lua_State* L, int idx) {
                 lua_pushvalue(L, idx); // push table to top of stack
@@ -93,6 +105,18 @@ namespace LuaScripting {
 
                 return CRGB(r, g, b);
             }
+
+            LEDHat::TextColors::Span lua_tospan(lua_State* L, int idx) {
+                static const char* const spans[] = { "text", "canvas", nullptr };
+                return static_cast<LEDHat::TextColors::Span>(luaL_checkoption(L, idx, "text", spans));
+            }
+
+            const Font& lua_tofont(lua_State* L, int idx) {
+                if( lua_isnoneornil(L, idx) ) {
+                    return Font::builtin();
+                }
+                return *static_cast<Font*>(luaL_checkudata(L, idx, FONT_METATABLE));
+            }
         }
 
         int getLED(lua_State* L) {
@@ -104,7 +128,7 @@ namespace LuaScripting {
             lua_Integer row = luaL_checkinteger(L, -1);
             lua_pop(L, 1);
 
-            auto pixel = LEDHat::Instance().getPixel(row - 1, col - 1);
+            auto pixel = output->getPixel(row - 1, col - 1);
 
             lua_createtable(L, 0, 0); // -4
 
@@ -128,6 +152,12 @@ namespace LuaScripting {
             lua_Integer row = luaL_checkinteger(L, -1);
             lua_pop(L, 1);
 
+            // a number is a palette index
+            if( lua_isinteger(L, 3) ) {
+                output->setPixelIndex(row - 1, col - 1, lua_tointeger(L, 3) );
+                return 0;
+            }
+
             lua_rawgeti(L, 3, 1); // r  -3
             lua_rawgeti(L, 3, 2); // g  -2
             lua_rawgeti(L, 3, 3); // b  -1
@@ -138,7 +168,7 @@ namespace LuaScripting {
 
             lua_pop(L, 3);
 
-            LEDHat::Instance().setPixel(row - 1, col - 1, CRGB(r, g, b) );
+            output->setPixel(row - 1, col - 1, CRGB(r, g, b) );
             return 0;
         }
 
@@ -166,12 +196,184 @@ namespace LuaScripting {
         }
 
         int show(lua_State* L) {
-            LEDHat::Instance().show();
+            output->show();
             return lua_yield(L, 0);
         }
 
+        int showAll(lua_State* L) {
+            LEDHat::showAll();
+            return lua_yield(L, 0);
+        }
+
+        int selectOutput(lua_State* L) {
+            // 1. arg = output (1 = hat)
+            const auto outputs = LEDHat::outputs();
+            const auto index = luaL_checkinteger(L, 1);
+            luaL_argcheck(L, index >= 1 && index <= static_cast<lua_Integer>(outputs.size()), 1, "unknown output");
+            output = outputs[index - 1];
+            lua_pushinteger(L, outputs.size());
+            return 1;
+        }
+
         int clear(lua_State* L) {
-            LEDHat::Instance().clear();
+            output->clear();
+            return 0;
+        }
+
+        int setCanvasWidth(lua_State* L) {
+            auto width = luaL_checkinteger(L, 1); // 1. arg = width
+            luaL_argcheck(L, width >= 1 && width <= static_cast<lua_Integer>(LEDHat::MAX_CANVAS_WIDTH), 1, "width out of range");
+
+            if( !output->setCanvasWidth(width) ) {
+                return luaL_argerror(L, 1, "canvas too large for the layers");
+            }
+            return 0;
+        }
+
+        int setViewport(lua_State* L) {
+            auto offset = luaL_checkinteger(L, 1); // 1. arg = offset
+
+            output->setViewport(offset);
+            return 0;
+        }
+
+        int setLayerCount(lua_State* L) {
+            auto count = luaL_checkinteger(L, 1); // 1. arg = count
+            luaL_argcheck(L, count >= 1 && count <= static_cast<lua_Integer>(LEDHat::MAX_LAYERS), 1, "count out of range");
+
+            if( !output->setLayerCount(count) ) {
+                return luaL_argerror(L, 1, "layers too large for the canvas");
+            }
+            return 0;
+        }
+
+        int selectLayer(lua_State* L) {
+            auto layer = luaL_checkinteger(L, 1); // 1. arg = layer (1-based)
+
+            output->selectLayer(layer - 1);
+            return 0;
+        }
+
+        int setLayerOpacity(lua_State* L) {
+            auto layer = luaL_checkinteger(L, 1); // 1. arg = layer (1-based)
+            auto opacity = luaL_checkinteger(L, 2); // 2. arg = opacity
+
+            output->setLayerOpacity(layer - 1, opacity);
+            return 0;
+        }
+
+        int setLayerBlendMode(lua_State* L) {
+            static const char* const modes[] = { "replace", "add", "alpha", "multiply", nullptr };
+
+            auto layer = luaL_checkinteger(L, 1); // 1. arg = layer (1-based)
+            auto mode = luaL_checkoption(L, 2, nullptr, modes); // 2. arg = blend mode name
+
+            output->setLayerBlendMode(layer - 1, static_cast<LEDHat::BlendMode>(mode));
+            return 0;
+        }
+
+        int setLayerIndexed(lua_State* L) {
+            auto layer = luaL_checkinteger(L, 1); // 1. arg = layer (1-based)
+            auto indexed = lua_toboolean(L, 2); // 2. arg = indexed
+
+            output->setLayerIndexed(layer - 1, indexed);
+            return 0;
+        }
+
+        int setPaletteColor(lua_State* L) {
+            auto index = luaL_checkinteger(L, 1); // 1. arg = palette index
+            auto color = Helpers::lua_tocolor(L, 2); // 2. arg = color
+
+            output->setPaletteColor(index, color);
+            return 0;
+        }
+
+        int rotatePalette(lua_State* L) {
+            auto steps = luaL_checkinteger(L, 1); // 1. arg = steps
+            auto first = luaL_optinteger(L, 2, 0); // 2. arg = first palette index
+            auto last = luaL_optinteger(L, 3, 255); // 3. arg = last palette index
+
+            output->rotatePalette(steps, first, last);
+            return 0;
+        }
+
+        int fillPaletteGradient(lua_State* L) {
+            auto first = luaL_checkinteger(L, 1); // 1. arg = first palette index
+            auto last = luaL_checkinteger(L, 2); // 2. arg = last palette index
+            auto from = Helpers::lua_tocolor(L, 3); // 3. arg = color of first index
+            auto to = Helpers::lua_tocolor(L, 4); // 4. arg = color of last index
+
+            output->fillPaletteGradient(first, last, from, to);
+            return 0;
+        }
+
+        int setBrightness(lua_State* L) {
+            auto brightness = luaL_checkinteger(L, 1); // 1. arg = brightness
+
+            output->setBrightness(brightness);
+            return 0;
+        }
+
+        int fadeBrightness(lua_State* L) {
+            auto brightness = luaL_checkinteger(L, 1); // 1. arg = target brightness
+            auto duration = luaL_checkinteger(L, 2); // 2. arg = duration in ms
+
+            output->fadeBrightness(brightness, duration);
+            return 0;
+        }
+
+        int setGamma(lua_State* L) {
+            auto red = luaL_checknumber(L, 1); // 1. arg = gamma of red (or all channels)
+            auto green = luaL_optnumber(L, 2, red); // 2. arg = gamma of green
+            auto blue = luaL_optnumber(L, 3, red); // 3. arg = gamma of blue
+
+            output->setGamma(red, green, blue);
+            return 0;
+        }
+
+        int setDithering(lua_State* L) {
+            auto enabled = lua_toboolean(L, 1); // 1. arg = enabled
+
+            output->setDithering(enabled);
+            return 0;
+        }
+
+        int setPowerBudget(lua_State* L) {
+            auto milliamps = luaL_checkinteger(L, 1); // 1. arg = budget in mA (0 = unlimited)
+
+            output->setPowerBudget(milliamps);
+            return 0;
+        }
+
+        int powerStats(lua_State* L) {
+            auto& hat = *output;
+
+            lua_createtable(L, 0, 2);
+
+            lua_pushinteger(L, hat.estimatedCurrent());
+            lua_setfield(L, -2, "current");
+
+            lua_pushinteger(L, hat.powerScale());
+            lua_setfield(L, -2, "scale");
+
+            return 1;
+        }
+
+        int frameStats(lua_State* L) {
+            auto& hat = *output;
+
+            lua_createtable(L, 0, 3);
+
+            lua_pushinteger(L, hat.sentFrames());
+            lua_setfield(L, -2, "sent");
+
+            lua_pushinteger(L, hat.skippedFrames());
+            lua_setfield(L, -2, "skipped");
+
+            lua_pushinteger(L, hat.droppedFrames());
+            lua_setfield(L, -2, "dropped");
+
+            return 1;
         }
 
         int drawText(lua_State* L) {
@@ -181,7 +383,414 @@ namespace LuaScripting {
             auto offsetY = luaL_checkinteger(L, 4); // 4. arg = offsetY
             auto wrapArround = lua_toboolean(L, 5); // 5.arg = wrapArround
 
-            LEDHat::Instance().drawText(text, color, offsetX, offsetY, wrapArround);
+            auto& font = Helpers::lua_tofont(L, 6); // 6. arg = font (optional)
+
+            output->drawText(text, color, offsetX, offsetY, wrapArround, font);
+            return 0;
+        }
+
+        int drawCachedText(lua_State* L) {
+            auto text = luaL_checkstring(L, 1); // 1. arg = text
+            auto color = Helpers::lua_tocolor(L, 2); // 2. arg = color
+            auto offsetX = luaL_checkinteger(L, 3); // 3. arg = offsetX
+            auto offsetY = luaL_checkinteger(L, 4); // 4. arg = offsetY
+            auto wrapArround = lua_toboolean(L, 5); // 5.arg = wrapArround
+
+            auto& font = Helpers::lua_tofont(L, 6); // 6. arg = font (optional)
+
+            output->drawCachedText(text, color, offsetX, offsetY, wrapArround, font);
+            return 0;
+        }
+
+        int setTracking(lua_State* L) {
+            auto tracking = luaL_checkinteger(L, 1); // 1. arg = columns between two characters
+
+            output->setTracking(tracking);
+            return 0;
+        }
+
+        int setKerning(lua_State* L) {
+            auto pair = luaL_checkstring(L, 1); // 1. arg = pair of characters (e.g. "AV")
+            auto adjustment = luaL_checkinteger(L, 2); // 2. arg = adjustment of the gap
+
+            const auto left = decodeUtf8(pair);
+            const auto right = decodeUtf8(pair);
+            luaL_argcheck(L, left != 0 && right != 0 && *pair == '\0', 1, "expected two characters");
+
+            output->setKerning(left, right, adjustment);
+            return 0;
+        }
+
+        int setMonospace(lua_State* L) {
+            auto monospace = lua_toboolean(L, 1); // 1. arg = monospace
+
+            output->setMonospace(monospace);
+            return 0;
+        }
+
+        /**
+         * Draws the text with the given colors, the arguments following the colors are the ones of drawText
+         *
+         * All arguments are checked before makeColors() builds the colors: a Lua error is a longjmp and would
+         * skip the destructor of their vector.
+         *
+         * @param idx Index of the offsetX argument
+         * @param fontIdx Index of the font argument
+         * @param makeColors Returns the LEDHat::TextColors, must not raise a Lua error
+         */
+        template<typename MakeColors>
+        static int drawColoredText(lua_State* L, int idx, int fontIdx, MakeColors makeColors) {
+            auto text = luaL_checkstring(L, 1); // 1. arg = text
+            auto offsetX = luaL_checkinteger(L, idx); // idx. arg = offsetX
+            auto offsetY = luaL_checkinteger(L, idx + 1); // idx + 1. arg = offsetY
+            auto wrapArround = lua_toboolean(L, idx + 2); // idx + 2. arg = wrapArround
+
+            auto& font = Helpers::lua_tofont(L, fontIdx); // fontIdx. arg = font (optional)
+
+            output->drawText(text, makeColors(), offsetX, offsetY, wrapArround, font);
+            return 0;
+        }
+
+        int drawColorText(lua_State* L) {
+            luaL_checktype(L, 2, LUA_TTABLE); // 2. arg = array of colors
+
+            const auto count = lua_rawlen(L, 2);
+            for( lua_Unsigned i = 1; i <= count; ++i ) {
+                lua_rawgeti(L, 2, i);
+                Helpers::lua_tocolor(L, -1);
+                lua_pop(L, 1);
+            }
+
+            // 3. - 6. arg = offsetX, offsetY, wrapArround, font (optional)
+            return drawColoredText(L, 3, 6, [L, count]() {
+                // the colors were checked above, lua_tocolor does not raise anymore
+                std::vector<CRGB> colors;
+                colors.reserve(count);
+                for( lua_Unsigned i = 1; i <= count; ++i ) {
+                    lua_rawgeti(L, 2, i);
+                    colors.push_back( Helpers::lua_tocolor(L, -1) );
+                    lua_pop(L, 1);
+                }
+                return LEDHat::TextColors::characters(std::move(colors));
+            });
+        }
+
+        int drawGradientText(lua_State* L) {
+            auto from = Helpers::lua_tocolor(L, 2); // 2. arg = color of the first column
+            auto to = Helpers::lua_tocolor(L, 3); // 3. arg = color of the last column
+            auto span = Helpers::lua_tospan(L, 7); // 7. arg = span "text" or "canvas" (optional)
+
+            // 4. - 6. & 8. arg = offsetX, offsetY, wrapArround, font (optional)
+            return drawColoredText(L, 4, 8, [=]() { return LEDHat::TextColors::gradient(from, to, span); });
+        }
+
+        int drawPaletteText(lua_State* L) {
+            auto first = luaL_checkinteger(L, 2); // 2. arg = palette index of the first column
+            auto last = luaL_checkinteger(L, 3); // 3. arg = palette index of the last column
+            auto span = Helpers::lua_tospan(L, 7); // 7. arg = span "text" or "canvas" (optional)
+
+            // 4. - 6. & 8. arg = offsetX, offsetY, wrapArround, font (optional)
+            return drawColoredText(L, 4, 8, [=]() { return LEDHat::TextColors::palette(first, last, span); });
+        }
+
+        int drawRainbowText(lua_State* L) {
+            auto hueOffset = luaL_checkinteger(L, 2); // 2. arg = hue of the first column (0 - 255)
+            auto span = Helpers::lua_tospan(L, 6); // 6. arg = span "text" or "canvas" (optional)
+
+            // 3. - 5. & 7. arg = offsetX, offsetY, wrapArround, font (optional)
+            return drawColoredText(L, 3, 7, [=]() { return LEDHat::TextColors::rainbow(hueOffset, span); });
+        }
+
+        int measureText(lua_State* L) {
+            auto text = luaL_checkstring(L, 1); // 1. arg = text
+            auto& font = Helpers::lua_tofont(L, 2); // 2. arg = font (optional)
+
+            lua_pushinteger(L, output->measureText(text, font));
+            return 1;
+        }
+
+        int drawAlignedText(lua_State* L) {
+            static const char* const aligns[] = { "left", "center", "right", nullptr };
+            static const char* const overflows[] = { "clip", "ellipsis", nullptr };
+
+            auto text = luaL_checkstring(L, 1); // 1. arg = text
+            auto color = Helpers::lua_tocolor(L, 2); // 2. arg = color
+            auto left = luaL_checkinteger(L, 3); // 3. arg = first column of the box
+            auto width = luaL_checkinteger(L, 4); // 4. arg = width of the box
+            auto align = luaL_checkoption(L, 5, "left", aligns); // 5. arg = alignment name
+            auto overflow = luaL_checkoption(L, 6, "clip", overflows); // 6. arg = overflow name
+            auto offsetY = luaL_optinteger(L, 7, 0); // 7. arg = offsetY
+            auto& font = Helpers::lua_tofont(L, 8); // 8. arg = font (optional)
+
+            output->drawAlignedText(text, color, left, width, static_cast<LEDHat::TextAlign>(align),
+                                    static_cast<LEDHat::TextOverflow>(overflow), offsetY, font);
+            return 0;
+        }
+
+        int scroll(lua_State* L) {
+            auto text = luaL_checkstring(L, 1); // 1. arg = text
+            auto color = Helpers::lua_tocolor(L, 2); // 2. arg = color
+            auto speed = luaL_checknumber(L, 3); // 3. arg = speed in columns per second
+            auto offsetY = luaL_optinteger(L, 4, 0); // 4. arg = offsetY (optional)
+
+            auto& font = Helpers::lua_tofont(L, 5); // 5. arg = font (optional)
+
+            output->scroll(text, color, speed, offsetY, font);
+            return 0;
+        }
+
+        int stopScroll(lua_State* L) {
+            output->stopScroll();
+            return 0;
+        }
+
+        /**
+         * Name of the metatable of sprite userdata
+         */
+        static const char* const SPRITE_METATABLE = "LEDHat.Sprite";
+
+        /**
+         * Pushes an empty sprite as userdata with the sprite metatable, so it is destroyed when it is collected
+         *
+         * @returns The sprite inside the userdata
+         */
+        static Sprite& pushSprite(lua_State* L) {
+            auto* sprite = new (lua_newuserdata(L, sizeof(Sprite))) Sprite();
+            luaL_setmetatable(L, SPRITE_METATABLE);
+            return *sprite;
+        }
+
+        int spriteGC(lua_State* L) {
+            static_cast<Sprite*>(luaL_checkudata(L, 1, SPRITE_METATABLE))->~Sprite();
+            return 0;
+        }
+
+        int spriteLength(lua_State* L) {
+            lua_pushinteger(L, static_cast<Sprite*>(luaL_checkudata(L, 1, SPRITE_METATABLE))->frameCount());
+            return 1;
+        }
+
+        int fontGC(lua_State* L) {
+            static_cast<Font*>(luaL_checkudata(L, 1, FONT_METATABLE))->~Font();
+            return 0;
+        }
+
+        /**
+         * Pushes an empty font as userdata with the font metatable, so it is destroyed when it is collected
+         *
+         * @returns The font inside the userdata
+         */
+        static Font& pushFont(lua_State* L) {
+            auto* font = new (lua_newuserdata(L, sizeof(Font))) Font();
+            luaL_setmetatable(L, FONT_METATABLE);
+            return *font;
+        }
+
+        int loadFont(lua_State* L) {
+            auto filename = luaL_checkstring(L, 1); // 1. arg = filename
+
+            // owned by lua from now on, the C++ objects below are gone before lua is called again
+            auto& font = pushFont(L);
+
+            const char* error = nullptr;
+            {
+                auto file = SPIFFS.open( (std::string("/") + filename).c_str() );
+                if( !file ) {
+                    error = "failed to open file";
+                } else {
+                    std::vector<uint8_t> data( file.size() );
+                    const auto size = file.read( data.data(), data.size() );
+                    file.close();
+
+                    if( size != data.size() || !Font::load( std::move(data), font ) ) {
+                        error = "invalid font";
+                    }
+                }
+            }
+
+            if( error != nullptr ) {
+                lua_pushnil(L);
+                lua_pushstring(L, error);
+                return 2;
+            }
+            return 1;
+        }
+
+        int createSprite(lua_State* L) {
+            luaL_checktype(L, 1, LUA_TTABLE); // 1. arg = palette (list of colors)
+            luaL_checktype(L, 2, LUA_TTABLE); // 2. arg = frames (list of frames, frame = list of row strings)
+
+            // Errors of lua jump over the destructors of C++ objects, so every argument is checked
+            // before the first object is built. Afterwards nothing raises an error anymore
+            for( lua_Integer i = 1; lua_rawgeti(L, 1, i) != LUA_TNIL; ++i ) {
+                Helpers::lua_tocolor(L, -1);
+                lua_pop(L, 1);
+            }
+            lua_pop(L, 1);
+
+            for( lua_Integer i = 1; lua_rawgeti(L, 2, i) != LUA_TNIL; ++i ) {
+                luaL_checktype(L, -1, LUA_TTABLE);
+                for( lua_Integer j = 1; lua_rawgeti(L, -1, j) != LUA_TNIL; ++j ) {
+                    luaL_checktype(L, -1, LUA_TSTRING); // no number conversion, which would allocate
+                    lua_pop(L, 1);
+                }
+                lua_pop(L, 2);
+            }
+            lua_pop(L, 1);
+
+            // owned by lua from now on, also if encoding fails
+            auto& sprite = pushSprite(L);
+
+            auto valid = false;
+            {
+                std::vector<CRGB> palette;
+                for( lua_Integer i = 1; lua_rawgeti(L, 1, i) != LUA_TNIL; ++i ) {
+                    palette.push_back( Helpers::lua_tocolor(L, -1) );
+                    lua_pop(L, 1);
+                }
+                lua_pop(L, 1);
+
+                std::vector<std::vector<std::string>> frames;
+                for( lua_Integer i = 1; lua_rawgeti(L, 2, i) != LUA_TNIL; ++i ) {
+                    frames.emplace_back();
+                    for( lua_Integer j = 1; lua_rawgeti(L, -1, j) != LUA_TNIL; ++j ) {
+                        frames.back().push_back( lua_tostring(L, -1) );
+                        lua_pop(L, 1);
+                    }
+                    lua_pop(L, 2);
+                }
+                lua_pop(L, 1);
+
+                valid = Sprite::encode( palette, frames, sprite );
+            }
+
+            if( !valid ) {
+                lua_pushnil(L);
+                lua_pushstring(L, "invalid sprite");
+                return 2;
+            }
+            return 1;
+        }
+
+        int loadSprite(lua_State* L) {
+            auto filename = luaL_checkstring(L, 1); // 1. arg = filename
+
+            // owned by lua from now on, the C++ objects below are gone before lua is called again
+            auto& sprite = pushSprite(L);
+
+            const char* error = nullptr;
+            {
+                auto file = SPIFFS.open( (std::string("/") + filename).c_str() );
+                if( !file ) {
+                    error = "failed to open file";
+                } else {
+                    std::string text;
+                    while( file.available() ) {
+                        text += file.readString().c_str();
+                    }
+                    file.close();
+
+                    if( !Sprite::parse( text, sprite ) ) {
+                        error = "invalid sprite";
+                    }
+                }
+            }
+
+            if( error != nullptr ) {
+                lua_pushnil(L);
+                lua_pushstring(L, error);
+                return 2;
+            }
+            return 1;
+        }
+
+        int drawSprite(lua_State* L) {
+            auto& sprite = *static_cast<Sprite*>(luaL_checkudata(L, 1, SPRITE_METATABLE)); // 1. arg = sprite
+            auto offsetX = luaL_checkinteger(L, 2); // 2. arg = offsetX
+            auto offsetY = luaL_checkinteger(L, 3); // 3. arg = offsetY
+            auto frame = luaL_optinteger(L, 4, 1); // 4. arg = frame (1-based)
+            auto wrapArround = lua_isnone(L, 5) || lua_toboolean(L, 5); // 5. arg = wrapArround
+
+            output->drawSprite(sprite, offsetX, offsetY, frame - 1, wrapArround);
+            return 0;
+        }
+
+        int fillRect(lua_State* L) {
+            auto row = luaL_checkinteger(L, 1); // 1. arg = top row (1-based)
+            auto col = luaL_checkinteger(L, 2); // 2. arg = left column (1-based)
+            auto height = luaL_checkinteger(L, 3); // 3. arg = height
+            auto width = luaL_checkinteger(L, 4); // 4. arg = width
+            auto color = Helpers::lua_tocolor(L, 5); // 5. arg = color
+
+            output->fillRect(row - 1, col - 1, height, width, color);
+            return 0;
+        }
+
+        int drawHLine(lua_State* L) {
+            auto row = luaL_checkinteger(L, 1); // 1. arg = row (1-based)
+            auto col = luaL_checkinteger(L, 2); // 2. arg = left column (1-based)
+            auto width = luaL_checkinteger(L, 3); // 3. arg = width
+            auto color = Helpers::lua_tocolor(L, 4); // 4. arg = color
+
+            output->drawHLine(row - 1, col - 1, width, color);
+            return 0;
+        }
+
+        int drawVLine(lua_State* L) {
+            auto row = luaL_checkinteger(L, 1); // 1. arg = top row (1-based)
+            auto col = luaL_checkinteger(L, 2); // 2. arg = column (1-based)
+            auto height = luaL_checkinteger(L, 3); // 3. arg = height
+            auto color = Helpers::lua_tocolor(L, 4); // 4. arg = color
+
+            output->drawVLine(row - 1, col - 1, height, color);
+            return 0;
+        }
+
+        int drawLine(lua_State* L) {
+            auto row0 = luaL_checkinteger(L, 1); // 1. arg = start row (1-based)
+            auto col0 = luaL_checkinteger(L, 2); // 2. arg = start column (1-based)
+            auto row1 = luaL_checkinteger(L, 3); // 3. arg = end row (1-based)
+            auto col1 = luaL_checkinteger(L, 4); // 4. arg = end column (1-based)
+            auto color = Helpers::lua_tocolor(L, 5); // 5. arg = color
+
+            output->drawLine(row0 - 1, col0 - 1, row1 - 1, col1 - 1, color);
+            return 0;
+        }
+
+        int drawCircle(lua_State* L) {
+            auto row = luaL_checkinteger(L, 1); // 1. arg = center row (1-based)
+            auto col = luaL_checkinteger(L, 2); // 2. arg = center column (1-based)
+            auto radius = luaL_checkinteger(L, 3); // 3. arg = radius
+            luaL_argcheck(L, radius >= 0 && radius <= LEDHat::MAX_COORDINATE, 3, "radius out of range");
+            auto color = Helpers::lua_tocolor(L, 4); // 4. arg = color
+            auto filled = lua_toboolean(L, 5); // 5. arg = filled
+
+            output->drawCircle(row - 1, col - 1, radius, color, filled);
+            return 0;
+        }
+
+        int fillGradient(lua_State* L) {
+            auto row = luaL_checkinteger(L, 1); // 1. arg = top row (1-based)
+            auto col = luaL_checkinteger(L, 2); // 2. arg = left column (1-based)
+            auto height = luaL_checkinteger(L, 3); // 3. arg = height
+            auto width = luaL_checkinteger(L, 4); // 4. arg = width
+            auto from = Helpers::lua_tocolor(L, 5); // 5. arg = start color
+            auto to = Helpers::lua_tocolor(L, 6); // 6. arg = end color
+            auto vertical = lua_toboolean(L, 7); // 7. arg = vertical
+
+            output->fillGradient(row - 1, col - 1, height, width, from, to, vertical);
+            return 0;
+        }
+
+        int fillRadialGradient(lua_State* L) {
+            auto row = luaL_checkinteger(L, 1); // 1. arg = center row (1-based)
+            auto col = luaL_checkinteger(L, 2); // 2. arg = center column (1-based)
+            auto radius = luaL_checkinteger(L, 3); // 3. arg = radius
+            luaL_argcheck(L, radius >= 0 && radius <= LEDHat::MAX_COORDINATE, 3, "radius out of range");
+            auto inner = Helpers::lua_tocolor(L, 4); // 4. arg = center color
+            auto outer = Helpers::lua_tocolor(L, 5); // 5. arg = border color
+
+            output->fillRadialGradient(row - 1, col - 1, radius, inner, outer);
             return 0;
         }
     }
@@ -224,6 +833,25 @@ namespace LuaScripting {
         lua_register(L, "millis", Proxy::lua_millis);
         lua_register(L, "readLine", Proxy::readLine );
 
+        // Create metatable of sprites
+        luaL_newmetatable(L, LEDHatProxy::SPRITE_METATABLE);
+        {
+            lua_pushcfunction(L, LEDHatProxy::spriteGC);
+            lua_setfield(L, -2, "__gc");
+
+            lua_pushcfunction(L, LEDHatProxy::spriteLength);
+            lua_setfield(L, -2, "__len");
+        }
+        lua_pop(L, 1);
+
+        // Create metatable of fonts
+        luaL_newmetatable(L, LEDHatProxy::FONT_METATABLE);
+        {
+            lua_pushcfunction(L, LEDHatProxy::fontGC);
+            lua_setfield(L, -2, "__gc");
+        }
+        lua_pop(L, 1);
+
         // Create LEDHat table for lua
         lua_createtable(L, 0, 0);
         {
@@ -231,6 +859,13 @@ namespace LuaScripting {
             lua_pushcfunction(L, LEDHatProxy::show);
             lua_setfield(L, -2, "show");
 
+            // registering output functions
+            lua_pushcfunction(L, LEDHatProxy::showAll);
+            lua_setfield(L, -2, "showAll");
+
+            lua_pushcfunction(L, LEDHatProxy::selectOutput);
+            lua_setfield(L, -2, "selectOutput");
+
             // registering clear function
             lua_pushcfunction(L, LEDHatProxy::clear);
             lua_setfield(L, -2, "clear");
@@ -239,8 +874,143 @@ namespace LuaScripting {
             lua_pushcfunction(L, LEDHatProxy::drawText);
             lua_setfield(L, -2, "drawText");
 
+            // registering drawCachedText function
+            lua_pushcfunction(L, LEDHatProxy::drawCachedText);
+            lua_setfield(L, -2, "drawCachedText");
+
+            // registering sprite functions
+            lua_pushcfunction(L, LEDHatProxy::createSprite);
+            lua_setfield(L, -2, "createSprite");
+
+            lua_pushcfunction(L, LEDHatProxy::loadSprite);
+            lua_setfield(L, -2, "loadSprite");
+
+            lua_pushcfunction(L, LEDHatProxy::drawSprite);
+            lua_setfield(L, -2, "drawSprite");
+
+            // registering rasterizer functions
+            lua_pushcfunction(L, LEDHatProxy::fillRect);
+            lua_setfield(L, -2, "fillRect");
+
+            lua_pushcfunction(L, LEDHatProxy::drawHLine);
+            lua_setfield(L, -2, "drawHLine");
+
+            lua_pushcfunction(L, LEDHatProxy::drawVLine);
+            lua_setfield(L, -2, "drawVLine");
+
+            lua_pushcfunction(L, LEDHatProxy::drawLine);
+            lua_setfield(L, -2, "drawLine");
+
+            lua_pushcfunction(L, LEDHatProxy::drawCircle);
+            lua_setfield(L, -2, "drawCircle");
+
+            lua_pushcfunction(L, LEDHatProxy::fillGradient);
+            lua_setfield(L, -2, "fillGradient");
+
+            lua_pushcfunction(L, LEDHatProxy::fillRadialGradient);
+            lua_setfield(L, -2, "fillRadialGradient");
+
+            // registering loadFont function
+            lua_pushcfunction(L, LEDHatProxy::loadFont);
+            lua_setfield(L, -2, "loadFont");
+
+            // registering text spacing functions
+            lua_pushcfunction(L, LEDHatProxy::setTracking);
+            lua_setfield(L, -2, "setTracking");
+
+            lua_pushcfunction(L, LEDHatProxy::setKerning);
+            lua_setfield(L, -2, "setKerning");
+
+            lua_pushcfunction(L, LEDHatProxy::setMonospace);
+            lua_setfield(L, -2, "setMonospace");
+
+            // registering colored text functions
+            lua_pushcfunction(L, LEDHatProxy::drawColorText);
+            lua_setfield(L, -2, "drawColorText");
+
+            lua_pushcfunction(L, LEDHatProxy::drawGradientText);
+            lua_setfield(L, -2, "drawGradientText");
+
+            lua_pushcfunction(L, LEDHatProxy::drawPaletteText);
+            lua_setfield(L, -2, "drawPaletteText");
+
+            lua_pushcfunction(L, LEDHatProxy::drawRainbowText);
+            lua_setfield(L, -2, "drawRainbowText");
+
+            // registering text measurement functions
+            lua_pushcfunction(L, LEDHatProxy::measureText);
+            lua_setfield(L, -2, "measureText");
+
+            lua_pushcfunction(L, LEDHatProxy::drawAlignedText);
+            lua_setfield(L, -2, "drawAlignedText");
+
+            // registering marquee functions
+            lua_pushcfunction(L, LEDHatProxy::scroll);
+            lua_setfield(L, -2, "scroll");
+
+            lua_pushcfunction(L, LEDHatProxy::stopScroll);
+            lua_setfield(L, -2, "stopScroll");
+
+            // registering setCanvasWidth function
+            lua_pushcfunction(L, LEDHatProxy::setCanvasWidth);
+            lua_setfield(L, -2, "setCanvasWidth");
+
+            // registering setViewport function
+            lua_pushcfunction(L, LEDHatProxy::setViewport);
+            lua_setfield(L, -2, "setViewport");
+
+            // registering layer functions
+            lua_pushcfunction(L, LEDHatProxy::setLayerCount);
+            lua_setfield(L, -2, "setLayerCount");
+
+            lua_pushcfunction(L, LEDHatProxy::selectLayer);
+            lua_setfield(L, -2, "selectLayer");
+
+            lua_pushcfunction(L, LEDHatProxy::setLayerOpacity);
+            lua_setfield(L, -2, "setLayerOpacity");
+
+            lua_pushcfunction(L, LEDHatProxy::setLayerBlendMode);
+            lua_setfield(L, -2, "setLayerBlendMode");
+
+            // registering palette functions
+            lua_pushcfunction(L, LEDHatProxy::setLayerIndexed);
+            lua_setfield(L, -2, "setLayerIndexed");
+
+            lua_pushcfunction(L, LEDHatProxy::setPaletteColor);
+            lua_setfield(L, -2, "setPaletteColor");
+
+            lua_pushcfunction(L, LEDHatProxy::rotatePalette);
+            lua_setfield(L, -2, "rotatePalette");
+
+            lua_pushcfunction(L, LEDHatProxy::fillPaletteGradient);
+            lua_setfield(L, -2, "fillPaletteGradient");
+
+            // registering output stage functions
+            lua_pushcfunction(L, LEDHatProxy::setBrightness);
+            lua_setfield(L, -2, "setBrightness");
+
+            lua_pushcfunction(L, LEDHatProxy::fadeBrightness);
+            lua_setfield(L, -2, "fadeBrightness");
+
+            lua_pushcfunction(L, LEDHatProxy::setGamma);
+            lua_setfield(L, -2, "setGamma");
+
+            lua_pushcfunction(L, LEDHatProxy::setDithering);
+            lua_setfield(L, -2, "setDithering");
+
+            // registering power limit functions
+            lua_pushcfunction(L, LEDHatProxy::setPowerBudget);
+            lua_setfield(L, -2, "setPowerBudget");
+
+            lua_pushcfunction(L, LEDHatProxy::powerStats);
+            lua_setfield(L, -2, "powerStats");
+
+            // registering frameStats function
+            lua_pushcfunction(L, LEDHatProxy::frameStats);
+            lua_setfield(L, -2, "frameStats");
+
             // create a raw object for every led matrix row
-            for( auto i = 1; i <= 8; ++i ) {
+            for( unsigned int i = 1; i <= LEDHat::Instance().rows(); ++i ) {
                 LEDHatProxy::createRow( L, i );
                 lua_rawseti(L, -2, i);
             }
@@ -256,6 +1026,9 @@ namespace LuaScripting {
             T = nullptr; // no active thread at the moment
         }
 
+        // New scripts draw on the hat
+        LEDHatProxy::output = &LEDHat::Instance();
+
         // Create new thread
         T = lua_newthread(L);
 
@@ -0,0 +1,102 @@
+#include "Sprite.h"
+
+#include <cstdlib>
+#include <sstream>
+
+int Sprite::pixelIndex(char c) {
+    if( c == '.' || c == ' ' ) {
+        return TRANSPARENT;
+    }
+    if( c >= '1' && c <= '9' ) {
+        return c - '0';
+    }
+    if( c >= 'a' && c <= 'z' ) {
+        return c - 'a' + 10;
+    }
+    if( c >= 'A' && c <= 'Z' ) {
+        return c - 'A' + 36;
+    }
+    return -1;
+}
+
+bool Sprite::encode(const std::vector<CRGB>& palette, const std::vector<std::vector<std::string>>& frames, Sprite& sprite) {
+    if( frames.empty() || frames[0].empty() || frames[0][0].empty() || palette.size() > MAX_COLORS ) {
+        return false;
+    }
+
+    sprite.width = frames[0][0].size();
+    sprite.height = frames[0].size();
+    sprite.palette = palette;
+    sprite.runs.clear();
+    sprite.frames.clear();
+
+    for( const auto& rows : frames ) {
+        if( rows.size() != sprite.height ) {
+            return false;
+        }
+        for( const auto& row : rows ) {
+            if( row.size() != sprite.width ) {
+                return false;
+            }
+        }
+
+        sprite.frames.push_back( sprite.runs.size() );
+
+        // runs continue over column boundaries, column by column like the led matrix
+        int runIndex = -1;
+        uint8_t runLength = 0;
+        for( unsigned int col = 0; col < sprite.width; ++col ) {
+            for( unsigned int row = 0; row < sprite.height; ++row ) {
+                const auto index = pixelIndex( rows[row][col] );
+                if( index < 0 || index > static_cast<int>( palette.size() ) ) {
+                    return false;
+                }
+
+                if( index == runIndex && runLength < 255 ) {
+                    ++runLength;
+                    continue;
+                }
+
+                if( runLength > 0 ) {
+                    sprite.runs.push_back( runLength );
+                    sprite.runs.push_back( runIndex );
+                }
+                runIndex = index;
+                runLength = 1;
+            }
+        }
+
+        sprite.runs.push_back( runLength );
+        sprite.runs.push_back( runIndex );
+    }
+
+    return true;
+}
+
+bool Sprite::parse(const std::string& text, Sprite& sprite) {
+    std::vector<CRGB> palette;
+    std::vector<std::vector<std::string>> frames;
+
+    std::istringstream lines( text );
+    std::string line;
+    while( std::getline( lines, line ) ) {
+        if( !line.empty() && line.back() == '\r' ) {
+            line.pop_back();
+        }
+
+        if( line.compare( 0, 7, "palette" ) == 0 ) {
+            std::istringstream colors( line.substr( 7 ) );
+            std::string color;
+            while( colors >> color ) {
+                const auto rgb = strtoul( color.c_str(), nullptr, 16 );
+                palette.push_back( CRGB( (rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF ) );
+            }
+        } else if( line == "frame" ) {
+            frames.emplace_back();
+        } else if( !line.empty() && !frames.empty() ) {
+            frames.back().push_back( line );
+        }
+    }
+
+    return encode( palette, frames, sprite );
+}
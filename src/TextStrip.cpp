@@ -0,0 +1,77 @@
+#include "TextStrip.h"
+
+#include <algorithm>
+
+const TextStrip& TextStripCache::get(const char* text, const Font& font, const TextSpacing& spacing) {
+    for( auto it = _strips.begin(); it != _strips.end(); ++it ) {
+        if( it->font == font.id() && it->text == text ) {
+            _strips.splice( _strips.begin(), _strips, it ); // mark as most recently used
+            return _strips.front();
+        }
+    }
+
+    // reuse the least recently used strip if the cache is full
+    if( _strips.size() >= _capacity ) {
+        _strips.splice( _strips.begin(), _strips, std::prev( _strips.end() ) );
+    } else {
+        _strips.emplace_front();
+    }
+
+    auto& strip = _strips.front();
+    strip.text = text;
+    strip.font = font.id();
+    rasterize( strip, font, spacing );
+
+    return strip;
+}
+
+void TextStripCache::rasterize(TextStrip& strip, const Font& font, const TextSpacing& spacing) {
+    strip.columns.clear();
+    strip.bits = font.bits();
+    const auto bits = strip.bits;
+
+    int position = 0;
+    const char* text = strip.text.c_str();
+    for( auto codepoint = decodeUtf8( text ); codepoint != 0; ) {
+        const auto next = decodeUtf8( text );
+
+        Character character;
+        if( !font.getCharacter( codepoint, character ) ) {
+            codepoint = next;
+            continue;
+        }
+
+        // glyphs may overlap with negative tracking or kerning
+        const auto start = position + spacing.offset( character );
+        for( unsigned int x = 0; x < character.width; ++x ) {
+            if( start + static_cast<int>(x) < 0 ) {
+                continue;
+            }
+            if( (start + x + 1) * bits > strip.columns.size() ) {
+                strip.columns.resize( (start + x + 1) * bits, 0 );
+            }
+
+            if( bits == 1 ) {
+                strip.columns[start + x] |= character.columns[x];
+            } else {
+                // overlapping pixels keep the higher coverage
+                const auto full = (1u << bits) - 1;
+                const auto glyph = glyphColumn( character.columns, bits, x );
+                auto column = glyphColumn( strip.columns.data(), bits, start + x );
+                for( unsigned int shift = 0; shift < 8 * bits; shift += bits ) {
+                    const auto level = std::max( column >> shift & full, glyph >> shift & full );
+                    column = (column & ~(full << shift)) | level << shift;
+                }
+                for( unsigned int i = 0; i < bits; ++i ) {
+                    strip.columns[(start + x) * bits + i] = column >> (8 * i);
+                }
+            }
+        }
+
+        position += spacing.advance( character, codepoint, next );
+        if( position * static_cast<int>(bits) > static_cast<int>(strip.columns.size()) ) {
+            strip.columns.resize( position * bits, 0 );
+        }
+        codepoint = next;
+    }
+}
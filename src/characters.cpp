@@ -1,15 +1,137 @@
+#include <algorithm>
+
 #include "characters.h"
 #include "characters_definition.h"
 
 
-bool getCharacter(const char c, Character& character) {
-    auto characterIndex = c - ' ';
+/**
+ * Gets the index of the Character entry of the codepoint
+ *
+ * @returns The index or -1 for control characters
+ */
+static int characterIndex(uint32_t codepoint) {
+    // fast path for ASCII
+    if( codepoint - FIRST_CODEPOINT < DIRECT_COUNT ) {
+        return codepoint - FIRST_CODEPOINT;
+    }
 
-    // check boundaries
-    if( characterIndex < 0 || characterIndex >= sizeof(characters) / sizeof(Character) ) {
+    if( codepoint < FIRST_CODEPOINT ) {
+        return -1;
+    }
+
+    const auto end = _codepoints + sizeof(_codepoints) / sizeof(_codepoints[0]);
+    const auto it = std::lower_bound( _codepoints, end, codepoint );
+    if( it != end && *it == codepoint ) {
+        return DIRECT_COUNT + (it - _codepoints);
+    }
+
+    return FALLBACK_INDEX;
+}
+
+bool getCharacter(uint32_t codepoint, Character& character) {
+    const auto index = characterIndex( codepoint );
+    if( index < 0 ) {
         return false;
     }
 
-    character = characters[ characterIndex ];
+    character = characters[ index ];
     return true;
 }
+
+int getCharacterWidth(uint32_t codepoint) {
+    const auto index = characterIndex( codepoint );
+    return index < 0 ? -1 : _widths[ index ];
+}
+
+uint32_t decodeUtf8(const char*& text) {
+    const auto lead = static_cast<uint8_t>( *text );
+    if( lead == 0 ) {
+        return 0;
+    }
+    ++text;
+
+    if( lead < 0x80 ) {
+        return lead;
+    }
+
+    // number of continuation bytes, payload of the lead byte & range of the first continuation byte.
+    // C0 & C1 only start overlong forms, leads above F4 only codepoints above U+10FFFF
+    unsigned int count;
+    uint32_t codepoint;
+    uint8_t lower = 0x80;
+    uint8_t upper = 0xBF;
+    if( lead >= 0xC2 && lead <= 0xDF ) {
+        count = 1;
+        codepoint = lead & 0x1F;
+    } else if( (lead & 0xF0) == 0xE0 ) {
+        count = 2;
+        codepoint = lead & 0x0F;
+        if( lead == 0xE0 ) {
+            lower = 0xA0; // overlong below U+0800
+        } else if( lead == 0xED ) {
+            upper = 0x9F; // surrogates U+D800 - U+DFFF
+        }
+    } else if( lead >= 0xF0 && lead <= 0xF4 ) {
+        count = 3;
+        codepoint = lead & 0x07;
+        if( lead == 0xF0 ) {
+            lower = 0x90; // overlong below U+10000
+        } else if( lead == 0xF4 ) {
+            upper = 0x8F; // beyond U+10FFFF
+        }
+    } else {
+        return REPLACEMENT_CHARACTER;
+    }
+
+    // an invalid sequence is replaced up to the byte which breaks it, that byte starts the next one.
+    // So C0 80 (an overlong 0) gives two replacement characters instead of ending the text
+    for( unsigned int i = 0; i < count; ++i ) {
+        const auto next = static_cast<uint8_t>( *text );
+        if( next < lower || next > upper ) {
+            return REPLACEMENT_CHARACTER;
+        }
+        codepoint = codepoint << 6 | (next & 0x3F);
+        lower = 0x80;
+        upper = 0xBF;
+        ++text;
+    }
+
+    return codepoint;
+}
+
+void TextSpacing::setKerning(uint32_t left, uint32_t right, int adjustment) {
+    const uint64_t pair = uint64_t(left) << 32 | right;
+    auto it = std::lower_bound( pairs.begin(), pairs.end(), pair, [](const std::pair<uint64_t, int8_t>& entry, uint64_t pair) { return entry.first < pair; } );
+
+    if( it != pairs.end() && it->first == pair ) {
+        if( adjustment == 0 ) {
+            pairs.erase( it );
+        } else {
+            it->second = adjustment;
+        }
+    } else if( adjustment != 0 ) {
+        pairs.insert( it, { pair, adjustment } );
+    }
+}
+
+int TextSpacing::kerning(uint32_t left, uint32_t right) const {
+    if( pairs.empty() ) {
+        return 0;
+    }
+
+    const uint64_t pair = uint64_t(left) << 32 | right;
+    auto it = std::lower_bound( pairs.begin(), pairs.end(), pair, [](const std::pair<uint64_t, int8_t>& entry, uint64_t pair) { return entry.first < pair; } );
+    return it != pairs.end() && it->first == pair ? it->second : 0;
+}
+
+int TextSpacing::advance(const Character& character, uint32_t c, uint32_t next) const {
+    if( monospace ) {
+        return character.leftBearing + character.width + character.rightBearing;
+    }
+
+    if( next == 0 ) {
+        return character.width;
+    }
+
+    return character.width + tracking + kerning( c, next );
+}
@@ -2,7 +2,11 @@
 #include <BluetoothSerial.h>
 #include <SPIFFS.h>
 
+#include <memory>
+
+#include "Benchmark.h"
 #include "CommandParser.h"
+#include "FrameCapture.h"
 #include "IO.h"
 #include "LEDHat.h"
 #include "LuaScripting.h"
@@ -10,6 +14,7 @@
 
 File file;
 CommandParser cmdParser;
+std::unique_ptr<FrameCapture> capture;
 
 void execute(const std::string& code) {
     LuaScripting::execute( code );
@@ -62,6 +67,38 @@ void dumpFile(const std::string& filename) {
     IO::write('\n');
 }
 
+void startCapture(FrameCapture* newCapture) {
+    LEDHat::setCapture( nullptr );
+    capture.reset( newCapture );
+
+    if( capture && !capture->isOpen() ) {
+        capture.reset();
+        IO::write( "Failed to open file!\n" );
+        return;
+    }
+    LEDHat::setCapture( capture.get() );
+}
+
+void captureFrames(const std::string& filename) {
+    if( filename.empty() ) {
+        startCapture( nullptr );
+        IO::write( "Capture stopped!\n" );
+        return;
+    }
+
+    // stdio reaches SPIFFS through its mount point
+    startCapture( new FrameCapture( ("/spiffs/" + filename).c_str() ) );
+    IO::write( "Frames will be recorded to " + filename + "\n" );
+}
+
+void previewFrames(const std::string& _) {
+    startCapture( new FrameCapture( nullptr, true ) );
+}
+
+void runBenchmark(const std::string& _) {
+    Benchmark::run( [](const std::string& line) { IO::write( line ); } );
+}
+
 void setup() {
     IO::init();
     SPIFFS.begin( true );
@@ -72,6 +109,9 @@ void setup() {
     cmdParser.addCommandHandler( "close", closeFile );
     cmdParser.addCommandHandler( "load", loadFile );
     cmdParser.addCommandHandler( "dump", dumpFile );
+    cmdParser.addCommandHandler( "capture", captureFrames );
+    cmdParser.addCommandHandler( "preview", previewFrames );
+    cmdParser.addCommandHandler( "bench", runBenchmark );
 
     LuaScripting::init();
 }
@@ -127,4 +167,9 @@ void handleIO() {
 void loop() {
     handleIO();
     LuaScripting::resume();
+
+    // marquees keep scrolling while scripts run or after they finished
+    for( auto* output : LEDHat::outputs() ) {
+        output->update();
+    }
 }
@@ -0,0 +1,50 @@
+#include <unity.h>
+
+#include "LEDHat.h"
+
+/**
+ * Draws a frame whose gamma & brightness leave fractions, shows it & counts the frames sent by idle show() calls
+ */
+static unsigned int idleFramesSent(LEDHat& hat) {
+    hat.clear();
+    hat.setPixel( 2, 5, CRGB( 200, 90, 30 ) );
+    hat.show();
+
+    const auto sent = hat.sentFrames();
+    for( int i = 0; i < 10; ++i ) {
+        hat.show();
+    }
+    return hat.sentFrames() - sent;
+}
+
+void setUp() {
+    auto& hat = LEDHat::Instance();
+    hat.setGamma( 2.2f, 2.2f, 2.2f );
+    hat.setBrightness( 100 );
+}
+
+void tearDown() {}
+
+void test_idle_frame_is_not_sent_by_default() {
+    TEST_ASSERT_EQUAL_UINT( 0, idleFramesSent( LEDHat::Instance() ) );
+}
+
+void test_idle_dithered_frame_is_sent_when_enabled() {
+    auto& hat = LEDHat::Instance();
+    hat.setDithering( true );
+    TEST_ASSERT_TRUE( idleFramesSent( hat ) > 0 );
+
+    // the frame settles as soon as dithering is disabled again
+    hat.setDithering( false );
+    hat.show();
+    TEST_ASSERT_EQUAL_UINT( 0, idleFramesSent( hat ) );
+}
+
+int main() {
+    LEDHat::Instance().setup();
+
+    UNITY_BEGIN();
+    RUN_TEST( test_idle_frame_is_not_sent_by_default );
+    RUN_TEST( test_idle_dithered_frame_is_sent_when_enabled );
+    return UNITY_END();
+}
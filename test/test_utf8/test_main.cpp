@@ -0,0 +1,103 @@
+#include <unity.h>
+
+#include "LEDHat.h"
+#include "characters.h"
+
+/**
+ * Decodes the whole text
+ *
+ * @param[out] codepoints The codepoints (without the terminating 0)
+ * @returns The number of codepoints
+ */
+static unsigned int decodeAll(const char* text, uint32_t* codepoints, unsigned int max) {
+    unsigned int count = 0;
+    for( auto codepoint = decodeUtf8( text ); codepoint != 0 && count < max; codepoint = decodeUtf8( text ) ) {
+        codepoints[count++] = codepoint;
+    }
+    return count;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_valid_sequences() {
+    uint32_t codepoints[8];
+    TEST_ASSERT_EQUAL_UINT( 5, decodeAll( "A\xC2\x80\xE2\x82\xAC\xED\x9F\xBF\xF4\x8F\xBF\xBF", codepoints, 8 ) );
+    TEST_ASSERT_EQUAL_HEX32( 'A', codepoints[0] );
+    TEST_ASSERT_EQUAL_HEX32( 0x80, codepoints[1] );
+    TEST_ASSERT_EQUAL_HEX32( 0x20AC, codepoints[2] );
+    TEST_ASSERT_EQUAL_HEX32( 0xD7FF, codepoints[3] );
+    TEST_ASSERT_EQUAL_HEX32( 0x10FFFF, codepoints[4] );
+}
+
+void test_overlong_sequences() {
+    // C0 80 is an overlong 0, it must not end the text
+    const char* overlong[] = { "\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xE0\x9F\xBF", "\xF0\x80\x80\x80", "\xF0\x8F\xBF\xBF" };
+    for( auto text : overlong ) {
+        TEST_ASSERT_EQUAL_HEX32( REPLACEMENT_CHARACTER, decodeUtf8( text ) );
+    }
+
+    // the lead byte & the continuation byte are replaced one by one
+    uint32_t codepoints[8];
+    TEST_ASSERT_EQUAL_UINT( 4, decodeAll( "A\xC0\x80Z", codepoints, 8 ) );
+    TEST_ASSERT_EQUAL_HEX32( REPLACEMENT_CHARACTER, codepoints[1] );
+    TEST_ASSERT_EQUAL_HEX32( REPLACEMENT_CHARACTER, codepoints[2] );
+    TEST_ASSERT_EQUAL_HEX32( 'Z', codepoints[3] );
+}
+
+void test_surrogates() {
+    const char* surrogates[] = { "\xED\xA0\x80", "\xED\xBF\xBF" };
+    for( auto text : surrogates ) {
+        TEST_ASSERT_EQUAL_HEX32( REPLACEMENT_CHARACTER, decodeUtf8( text ) );
+    }
+}
+
+void test_out_of_range() {
+    const char* outOfRange[] = { "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xF7\xBF\xBF\xBF", "\xF8", "\xFF" };
+    for( auto text : outOfRange ) {
+        TEST_ASSERT_EQUAL_HEX32( REPLACEMENT_CHARACTER, decodeUtf8( text ) );
+    }
+}
+
+void test_truncated_sequences() {
+    // the byte which breaks the sequence starts the next codepoint
+    uint32_t codepoints[8];
+    TEST_ASSERT_EQUAL_UINT( 3, decodeAll( "\xE2\x82Z\xF0\x9F", codepoints, 8 ) );
+    TEST_ASSERT_EQUAL_HEX32( REPLACEMENT_CHARACTER, codepoints[0] );
+    TEST_ASSERT_EQUAL_HEX32( 'Z', codepoints[1] );
+    TEST_ASSERT_EQUAL_HEX32( REPLACEMENT_CHARACTER, codepoints[2] );
+
+    // a lone continuation byte
+    const char* text = "\x80";
+    TEST_ASSERT_EQUAL_HEX32( REPLACEMENT_CHARACTER, decodeUtf8( text ) );
+    TEST_ASSERT_EQUAL_HEX32( 0, decodeUtf8( text ) );
+}
+
+void test_non_nul_lead_never_ends_text() {
+    // every lead byte followed by every continuation byte (or the end of the text)
+    for( unsigned int lead = 1; lead < 0x100; ++lead ) {
+        for( unsigned int next = 0x7F; next < 0xC0; ++next ) {
+            const char bytes[] = { static_cast<char>( lead ), static_cast<char>( next ), static_cast<char>( next ), static_cast<char>( next ), 0 };
+            const char* text = bytes;
+            TEST_ASSERT_NOT_EQUAL( 0, decodeUtf8( text ) );
+        }
+    }
+}
+
+void test_measure_text_with_invalid_sequence() {
+    LEDHat hat( MatrixGeometry::of<HatLayout>() );
+    TEST_ASSERT_EQUAL_UINT( hat.measureText( "A\xEF\xBF\xBD\xEF\xBF\xBDZ" ), hat.measureText( "A\xC0\x80Z" ) );
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST( test_valid_sequences );
+    RUN_TEST( test_overlong_sequences );
+    RUN_TEST( test_surrogates );
+    RUN_TEST( test_out_of_range );
+    RUN_TEST( test_truncated_sequences );
+    RUN_TEST( test_non_nul_lead_never_ends_text );
+    RUN_TEST( test_measure_text_with_invalid_sequence );
+    return UNITY_END();
+}
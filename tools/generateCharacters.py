@@ -1,37 +1,165 @@
+import argparse
+import struct
 import sys
 import re
 
-with open('contrast.flf') as f:
+# Generates the compiled font (characters_definition.h, printed) or a binary font file from a FIGlet font
+#
+#   python3 generateCharacters.py > ../include/characters_definition.h
+#   python3 generateCharacters.py other.flf --binary ../data/other.fnt
+#   python3 generateCharacters.py big.flf --binary ../data/smooth.fnt --supersample 2 --coverage 4
+#
+# Anti-aliased fonts are drawn from a FIGlet font supersample times higher & wider than the led matrix: every
+# pixel gets the share of lit pixels in its supersample x supersample block, quantized to 2 or 4 coverage bits.
+#
+# Binary fonts are loaded at runtime from SPIFFS (upload the data folder with "pio run -t uploadfs"). Layout, little endian:
+#
+#   char[4] "LHFN"
+#   uint8   version (1 or 2)
+#   uint8   height (rows, at most 8)
+#   uint16  glyph count (the last glyph is the fallback)
+#   uint16  direct count (glyphs of the codepoints first codepoint .. first codepoint + direct count - 1)
+#   uint16  first codepoint
+#   uint8   coverage bits per pixel (1, 2 or 4), version 2 only
+#   uint8   reserved, version 2 only
+#   glyph count * { uint16 column offset, uint8 width, uint8 left bearing, uint8 right bearing, uint8 reserved }
+#   uint32  codepoints of the glyphs following the direct ones, sorted (glyph count - direct count - 1)
+#   uint8   columns of all glyphs, coverage bits bytes per column: row n in the bits n * coverage bits ..
+#           (1 bit: bit n = row n). The column offsets count columns
+parser = argparse.ArgumentParser()
+parser.add_argument('font', nargs='?', default='contrast.flf', help='FIGlet font')
+parser.add_argument('--binary', help='write a binary font file instead of printing the C definition')
+parser.add_argument('--supersample', type=int, default=1, help='resolution of the FIGlet font relative to the led matrix')
+parser.add_argument('--coverage', type=int, choices=[1, 2, 4], default=1, help='coverage bits per pixel (anti-aliasing)')
+args = parser.parse_args()
+
+if args.coverage > 1 and not args.binary:
+    sys.exit('anti-aliased glyphs are supported by binary fonts only')
+
+with open(args.font, encoding='latin-1') as f:
     header = f.readline()
-    if match := re.search(r'flf2a\$ (-?\d+) (-?\d+) (-?\d+) (-?\d+) (-?\d+)', header):
-        height, maxLen, comments = int(match[1]), int(match[3]), int(match[5])
+    if match := re.search(r'flf2a(.) (-?\d+) (-?\d+) (-?\d+) (-?\d+) (-?\d+)', header):
+        hardblank, height, maxLen, comments = match[1], int(match[2]), int(match[4]), int(match[6])
     else:
         sys.exit(0)
 
+    if height > 8 * args.supersample:
+        sys.exit('only fonts with up to 8 rows (times supersample) are supported')
+
     # skip comments
     for i in range(comments):
         f.readline()
 
-    chars = []
-    for i in range( ord('}') - ord(' ') ):
-        data = ""
-        width = 0
+    def readGlyph():
+        lines = []
         for row in range(height):
-            line = f.readline().replace('@', '').replace('\r', '').replace('\n', '') \
-                .replace('.', '0') \
-                .replace('%', '1')
-            width = len(line) # Should be equal over lines
-            data += line
-        chars.append( (width, data) )
+            line = f.readline().rstrip('\r\n')
+            endmark = line[-1:]
+            lines.append( line.rstrip(endmark) )
+
+        # every character but blanks is a lit pixel
+        width = max(len(line) for line in lines)
+        lit = [[c not in (' ', '.', hardblank) for c in line.ljust(width)] for line in lines]
+
+        # coverage of every pixel: share of the lit pixels in its block of the supersampled glyph
+        n = args.supersample
+        rows, cols = -(-height // n), -(-width // n)
+        data = []
+        for row in range(rows):
+            for col in range(cols):
+                count = sum(lit[y][x] for y in range(row * n, min(height, (row + 1) * n)) for x in range(col * n, min(width, (col + 1) * n)))
+                data.append(round(count * LEVEL / (n * n)))
+        return (cols, data)
+
+    LEVEL = (1 << args.coverage) - 1  # coverage of a lit pixel
+
+    # required characters: ASCII 32-126 followed by the german ones
+    codepoints = list(range(ord(' '), ord('~') + 1)) + [0xC4, 0xD6, 0xDC, 0xE4, 0xF6, 0xFC, 0xDF]
+    glyphs = {codepoint: readGlyph() for codepoint in codepoints}
+
+    # code tagged characters: a line with the codepoint followed by the glyph
+    while tag := f.readline().split():
+        codepoint = int(tag[0], 0)
+        glyph = readGlyph()
+        if codepoint >= 0:
+            glyphs[codepoint] = glyph
+
+ASCII = range(ord(' '), ord('~') + 1)
+height = -(-height // args.supersample)
+
+# ASCII is indexed directly, the other codepoints are looked up in a sorted table
+extended = sorted(codepoint for codepoint in glyphs if codepoint not in ASCII)
+order = list(ASCII) + extended
+chars = [glyphs[codepoint] for codepoint in order]
+
+# fallback for codepoints missing in the font: a box
+boxWidth = height - 1
+box = ['1' * boxWidth] + ['1' + '0' * (boxWidth - 2) + '1'] * (height - 3) + ['1' * boxWidth, '0' * boxWidth]
+chars.append( (boxWidth, [LEVEL * int(c) for c in ''.join(box)]) )
+names = [chr(codepoint) for codepoint in order] + ['fallback']
 
-text = "".join([c[1] for c in chars])
-print( f'const char _text[] = "{text}";\n')
+# width of blank glyphs (space) after trimming
+BLANK_WIDTH = 2
+
+# pack every column into coverage bytes: the pixel in row n is stored in the bits n * coverage ..
+# (one byte per column with bit n set if the pixel in row n is lit for plain fonts)
+# blank columns on the left & right are trimmed and kept as bearings
+columns = []
+bearings = []
+for width, data in chars:
+    packed = [sum(data[row * width + col] << (row * args.coverage) for row in range(height)) for col in range(width)]
+    lit = [col for col, bits in enumerate(packed) if bits != 0]
+    if lit:
+        left, right = lit[0], width - 1 - lit[-1]
+    else:
+        left, right = 0, max(0, width - BLANK_WIDTH)
+    columns.append( packed[left:width - right] )
+    bearings.append( (left, right) )
+
+if args.binary:
+    # version 1 keeps plain fonts loadable by older firmware
+    if args.coverage == 1:
+        data = struct.pack('<4sBBHHH', b'LHFN', 1, height, len(columns), len(ASCII), ASCII[0])
+    else:
+        data = struct.pack('<4sBBHHHBB', b'LHFN', 2, height, len(columns), len(ASCII), ASCII[0], args.coverage, 0)
+    offset = 0
+    for i, c in enumerate(columns):
+        left, right = bearings[i]
+        data += struct.pack('<HBBBB', offset, len(c), left, right, 0)
+        offset += len(c)
+    data += b''.join(struct.pack('<I', codepoint) for codepoint in extended)
+    data += b''.join(col.to_bytes(args.coverage, 'little') for c in columns for col in c)
+
+    with open(args.binary, 'wb') as out:
+        out.write(data)
+    sys.exit(0)
+
+print( 'const uint8_t _columns[] = {')
+for i, c in enumerate(columns):
+    print( '\t' + ' '.join(f'0x{col:02x},' for col in c) + f' /* {names[i]} */' )
+print( '};\n')
+
+# widths on their own, so measuring text never touches the glyph columns
+print( 'const uint8_t _widths[] = {')
+for i, c in enumerate(columns):
+    print( f'\t{len(c)}, /* {names[i]} */' )
+print( '};\n')
 
 print( 'const Character characters[] = {')
 offset = 0
-for i, c in enumerate(chars):
-    width = c[0]
-    i = i + ord(' ')
-    print( f'\tCharacter({width}, {height}, &_text[{offset}]), /* {chr(i)} */' )
-    offset += width * height
-print( '};')
\ No newline at end of file
+for i, c in enumerate(columns):
+    width = len(c)
+    left, right = bearings[i]
+    print( f'\tCharacter({width}, {height}, &_columns[{offset}], {left}, {right}), /* {names[i]} */' )
+    offset += width
+print( '};\n')
+
+print( f'const uint32_t FIRST_CODEPOINT = {ASCII[0]};' )
+print( f'const unsigned int DIRECT_COUNT = {len(ASCII)};\n' )
+
+print( '/* codepoints of the characters following the directly indexed ones, sorted */' )
+print( 'const uint32_t _codepoints[] = {' )
+print( '\t' + ' '.join(f'0x{codepoint:04x},' for codepoint in extended) )
+print( '};\n' )
+
+print( f'const unsigned int FALLBACK_INDEX = {len(chars) - 1};' )